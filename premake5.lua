@@ -1,5 +1,17 @@
 -- @file premake5.lua
 
+-- Options
+newoption {
+    trigger = "dispatch",
+    value = "MODE",
+    description = "Choose how the CPU emulator dispatches instructions",
+    allowed = {
+        { "threaded", "Jump from handler to handler through a table of labels (GCC and Clang only)" },
+        { "switch", "Loop over a portable 'switch' statement" }
+    },
+    default = "threaded"
+}
+
 -- Workspace Settings
 workspace "project-tm"
     language "C++"
@@ -20,6 +32,8 @@ workspace "project-tm"
         optimize "On"
     filter { "system:linux" }
         defines { "TM_LINUX" }
+    filter { "options:dispatch=threaded" }
+        defines { "TM_THREADED_DISPATCH" }
     filter {}
 
     -- CPU Emulator Backend
@@ -58,3 +72,47 @@ workspace "project-tm"
         links { 
             "tmc", "m"
         }
+
+    -- CPU Emulator Benchmark Tool
+    project "tmb"
+        kind "ConsoleApp"
+        location "./generated/tmb"
+        targetdir "./build/bin/tmb/%{cfg.buildcfg}"
+        objdir "./build/obj/tmb/%{cfg.buildcfg}"
+        pchheader "./projects/tmb/include/TMB.Precompiled.hpp"
+        pchsource "./projects/tmb/src/TMB.Precompiled.cpp"
+        includedirs {
+            "./projects/tmc/include",
+            "./projects/tmb/include"
+        }
+        files {
+            "./projects/tmb/src/TMB.*.cpp"
+        }
+        libdirs {
+            "./build/bin/tmc/%{cfg.buildcfg}"
+        }
+        links {
+            "tmc"
+        }
+
+    -- CPU Emulator Test Tool
+    project "tmt"
+        kind "ConsoleApp"
+        location "./generated/tmt"
+        targetdir "./build/bin/tmt/%{cfg.buildcfg}"
+        objdir "./build/obj/tmt/%{cfg.buildcfg}"
+        pchheader "./projects/tmt/include/TMT.Precompiled.hpp"
+        pchsource "./projects/tmt/src/TMT.Precompiled.cpp"
+        includedirs {
+            "./projects/tmc/include",
+            "./projects/tmt/include"
+        }
+        files {
+            "./projects/tmt/src/TMT.*.cpp"
+        }
+        libdirs {
+            "./build/bin/tmc/%{cfg.buildcfg}"
+        }
+        links {
+            "tmc"
+        }
@@ -0,0 +1,10 @@
+/// @file TMB.Precompiled.hpp
+
+#ifndef TMB_PRECOMPILED_HPP
+#define TMB_PRECOMPILED_HPP
+
+#include <iomanip>
+#include <chrono>
+#include <TMC.Precompiled.hpp>
+
+#endif
@@ -0,0 +1,217 @@
+/// @file TMB.Main.cpp
+
+#include <TMB.Precompiled.hpp>
+#include <TMC.Arguments.hpp>
+#include <TMC.Processor.hpp>
+#include <TMC.ROMImage.hpp>
+
+struct Options
+{
+    tmc::Index                      mLimit      = 0;
+    tmc::Index                      mRounds     = 0;
+    tmc::Processor::ExecutionMode   mMode       = tmc::Processor::ExecutionMode::Tiered;
+    tmc::Uint32                     mThreshold  = tmc::Processor::DEFAULT_RECOMPILE_THRESHOLD;
+    tmc::Boolean                    mReport     = false;
+};
+
+const tmc::Char* GetModeName (const tmc::Processor::ExecutionMode& pMode)
+{
+    switch (pMode)
+    {
+        case tmc::Processor::ExecutionMode::Interpret:  return "interpret";
+        case tmc::Processor::ExecutionMode::Recompile:  return "recompile";
+        default:                                        return "tiered";
+    }
+}
+
+void ReportStatistics (const tmc::Processor& pProcessor)
+{
+    // Counts are totals over every round; only the first translates any blocks. Cycles are those
+    // of the last round alone.
+    const tmc::Processor::Statistics& lStats = pProcessor.GetStatistics();
+    const tmc::Float64 lEntered = static_cast<tmc::Float64>(std::max<tmc::Uint64>(lStats.mBlocksEntered, 1));
+    const tmc::Float64 lTranslated = static_cast<tmc::Float64>(std::max<tmc::Uint64>(lStats.mBlocksTranslated, 1));
+
+    std::cout << std::fixed << std::setprecision(2) <<
+        "    blocks entered:     " << lStats.mBlocksEntered << "\n" <<
+        "    hit rate:           " << 100.0 * (lStats.mBlocksChained + lStats.mBlocksFound) / lEntered << "%" <<
+            " (" << 100.0 * lStats.mBlocksChained / lEntered << "% chained)\n" <<
+        "    average length:     " << lStats.mInstructionsExecuted / lEntered << " executed, " <<
+            lStats.mInstructionsTranslated / lTranslated << " translated\n" <<
+        "    blocks translated:  " << lStats.mBlocksTranslated << "\n" <<
+        "    blocks recompiled:  " << lStats.mBlocksRecompiled << "\n" <<
+        "    run natively:       " << 100.0 * lStats.mBlocksRunNatively / lEntered << "%\n" <<
+        "    cycles:             " << pProcessor.GetCycles() << " (" <<
+            static_cast<tmc::Float64>(pProcessor.GetCycles()) /
+            static_cast<tmc::Float64>(std::max<tmc::Uint64>(pProcessor.GetInstructionCount(), 1)) <<
+            " per instruction)" << std::endl;
+}
+
+tmc::Int32 BenchmarkFile (const tmc::String& pInputFile, const Options& pOptions)
+{
+    tmc::ROMImage::Ptr lImage = tmc::ROMImage::Load(pInputFile);
+    if (lImage == nullptr)
+    {
+        return 2;
+    }
+
+    tmc::Bus lBus;
+    lBus.AttachProgram(lImage->GetData(), lImage->GetSize());
+
+    // Each round starts the program afresh, and the fastest round is reported, which discounts
+    // whatever else the host was doing at the time.
+    tmc::Processor  lProcessor { lBus };
+    tmc::Float64    lBest = 0.0;
+    tmc::Index      lCount = 0;
+
+    lProcessor.SetExecutionMode(pOptions.mMode, pOptions.mThreshold);
+    for (tmc::Index lRound = 0; lRound < pOptions.mRounds; ++lRound)
+    {
+        lProcessor.Reset();
+
+        const auto lStart = std::chrono::steady_clock::now();
+        lCount = lProcessor.Run(pOptions.mLimit);
+        const std::chrono::duration<tmc::Float64> lElapsed = std::chrono::steady_clock::now() - lStart;
+
+        if (lElapsed.count() > 0.0)
+        {
+            lBest = std::max(lBest, static_cast<tmc::Float64>(lCount) / lElapsed.count() / 1e6);
+        }
+    }
+
+    if (lProcessor.IsStopped() == true)
+    {
+        std::cerr << "[BenchmarkFile] '" << pInputFile << "' stopped after " << lCount <<
+            " instructions, with error code 0x" << std::hex << static_cast<tmc::Uint32>(lProcessor.GetErrorCode()) <<
+            std::dec << "." << std::endl;
+    }
+
+    std::cout << std::left << std::setw(32) << tmc::Path { pInputFile }.filename().string() <<
+        std::setw(10) << tmc::Processor::DISPATCH_NAME << std::setw(11) << GetModeName(pOptions.mMode) <<
+        std::right << std::setw(12) << lCount << std::fixed << std::setprecision(1) << std::setw(10) << lBest <<
+        " MIPS" << std::endl;
+
+    if (pOptions.mReport == true)
+    {
+        ReportStatistics(lProcessor);
+    }
+
+    return 0;
+}
+
+tmc::Int32 CompareFile (const tmc::String& pInputFile, const Options& pOptions)
+{
+    // The program is run once with every block interpreted, and once with every block compiled,
+    // and everything either run could have changed must then match.
+    tmc::ROMImage::Ptr lImage = tmc::ROMImage::Load(pInputFile);
+    if (lImage == nullptr)
+    {
+        return 2;
+    }
+
+    tmc::Bus lInterpretedBus, lCompiledBus;
+    tmc::Processor lInterpreted { lInterpretedBus }, lCompiled { lCompiledBus };
+    for (tmc::Bus* lBus : { &lInterpretedBus, &lCompiledBus })
+    {
+        lBus->AttachProgram(lImage->GetData(), lImage->GetSize());
+    }
+
+    lInterpreted.SetExecutionMode(tmc::Processor::ExecutionMode::Interpret);
+    lCompiled.SetExecutionMode(tmc::Processor::ExecutionMode::Recompile);
+
+    const tmc::Index lCount = lInterpreted.Run(pOptions.mLimit);
+    const tmc::Boolean lSameCount = lCompiled.Run(pOptions.mLimit) == lCount;
+
+    tmc::Boolean lSame = lSameCount == true &&
+        lInterpreted.GetFlags() == lCompiled.GetFlags() &&
+        lInterpreted.GetErrorCode() == lCompiled.GetErrorCode() &&
+        lInterpreted.GetPC() == lCompiled.GetPC() &&
+        lInterpreted.GetSP() == lCompiled.GetSP() &&
+        lInterpreted.GetRP() == lCompiled.GetRP();
+
+    for (tmc::Uint8 lRegister = 0; lRegister < 16; lRegister += 4)
+    {
+        lSame = lSame && lInterpreted.GetRegister(lRegister) == lCompiled.GetRegister(lRegister);
+    }
+
+    for (tmc::Index lOffset = 0; lOffset < lInterpretedBus.GetRAMSize() && lSame == true; ++lOffset)
+    {
+        const tmc::Address lAddress = static_cast<tmc::Address>(tmc::RAM_START + lOffset);
+        lSame = lInterpretedBus.Read<tmc::Byte>(lAddress) == lCompiledBus.Read<tmc::Byte>(lAddress);
+    }
+
+    std::cout << std::left << std::setw(32) << tmc::Path { pInputFile }.filename().string() <<
+        std::right << std::setw(12) << lCount << ((lSame == true) ? "  match" : "  MISMATCH") << std::endl;
+
+    if (lSame == false)
+    {
+        std::cout << std::hex << std::setfill('0') <<
+            "    PC " << std::setw(8) << lInterpreted.GetPC() << " / " << std::setw(8) << lCompiled.GetPC() <<
+            "    F " << std::setw(2) << static_cast<tmc::Uint32>(lInterpreted.GetFlags()) << " / " <<
+                std::setw(2) << static_cast<tmc::Uint32>(lCompiled.GetFlags()) << "\n";
+
+        for (tmc::Uint8 lRegister = 0; lRegister < 16; lRegister += 4)
+        {
+            std::cout << "    " << static_cast<tmc::Char>('A' + lRegister / 4) << "  " <<
+                std::setw(8) << lInterpreted.GetRegister(lRegister) << " / " <<
+                std::setw(8) << lCompiled.GetRegister(lRegister) << "\n";
+        }
+
+        std::cout << std::dec << std::setfill(' ') << std::flush;
+        return 3;
+    }
+
+    return 0;
+}
+
+int main (int pArgCount, char** pArgVector)
+{
+    // Capture command-line arguments.
+    tmc::Arguments::Capture(pArgCount, pArgVector);
+
+    const tmc::Index lInputCount = tmc::Arguments::Count("input-file", 'i');
+    if (lInputCount == 0 || tmc::Arguments::Get("input-file", 'i').empty() == true)
+    {
+        std::cerr << "[Main] Missing parameter: --input-file, -i." << std::endl;
+        return 1;
+    }
+
+    Options lOptions;
+    lOptions.mLimit = std::strtoull(tmc::Arguments::Get("instructions", 'n', "100000000").c_str(), nullptr, 0);
+    lOptions.mRounds = std::strtoull(tmc::Arguments::Get("rounds", 'r', "3").c_str(), nullptr, 0);
+    if (lOptions.mLimit == 0 || lOptions.mRounds == 0)
+    {
+        std::cerr << "[Main] The instruction limit and round count must both be positive." << std::endl;
+        return 1;
+    }
+
+    const tmc::String lMode = tmc::Arguments::Get("execution", 'x', "tiered");
+    if (lMode == "interpret")       { lOptions.mMode = tmc::Processor::ExecutionMode::Interpret; }
+    else if (lMode == "recompile")  { lOptions.mMode = tmc::Processor::ExecutionMode::Recompile; }
+    else if (lMode != "tiered")
+    {
+        std::cerr << "[Main] Unknown execution mode '" << lMode << "'; expected 'interpret', 'tiered' or 'recompile'." <<
+            std::endl;
+        return 1;
+    }
+
+    lOptions.mThreshold = static_cast<tmc::Uint32>(std::strtoul(tmc::Arguments::Get("threshold", 't',
+        std::to_string(tmc::Processor::DEFAULT_RECOMPILE_THRESHOLD)).c_str(), nullptr, 0));
+    lOptions.mReport = tmc::Arguments::Has("stats", 'S');
+
+    const tmc::Boolean lCompare = tmc::Arguments::Has("compare", 'c');
+
+    tmc::Int32 lResult = 0;
+    for (tmc::Index lIndex = 0; lIndex < lInputCount; ++lIndex)
+    {
+        const tmc::String& lInputFile = tmc::Arguments::Get("input-file", 'i', lIndex);
+        const tmc::Int32 lFileResult = (lCompare == true) ? CompareFile(lInputFile, lOptions) :
+            BenchmarkFile(lInputFile, lOptions);
+        if (lResult == 0)
+        {
+            lResult = lFileResult;
+        }
+    }
+
+    return lResult;
+}
@@ -0,0 +1,3 @@
+/// @file TMB.Precompiled.cpp
+
+#include <TMB.Precompiled.hpp>
@@ -11,7 +11,9 @@ namespace tmc
     {
     public:
         static void Capture (Int32 pArgCount, Char** pArgVector);
+        static void Clear ();
         static Boolean Has (const String& pKey, const Char& pShort);
+        static Index Count (const String& pKey, const Char& pShort);
         static const String& Get (const String& pKey, const Char& pShort, const String& pDefault = "");
         static const String& Get (const String& pKey, const Char& pShort, const Index& pIndex, const String& pDefault = "");
 
@@ -0,0 +1,144 @@
+/// @file TMC.Bus.hpp
+
+#pragma once
+
+#include <TMC.Common.hpp>
+#include <bit>
+#include <cstring>
+
+namespace tmc
+{
+
+    static_assert(std::endian::native == std::endian::little);
+
+    // Connects the processor to the TM's address space: the ROM image, RAM, the general-purpose
+    // and call stacks, QRAM, and the hardware registers at the very top of it.
+    //
+    // Every value is little-endian. Reads of any address which is not backed by memory yield
+    // zero, and writes to one - or to ROM - are ignored.
+    //
+    // The address space is split into 4 KiB pages, found through a two-level table: the top ten
+    // bits of an address select a table, and the next ten a page within it. A page backed by
+    // memory holds host pointers to read it and to write it through; one which is not reads from
+    // a page of zeroes, and writes into a page which is never read. Any other page - the one
+    // holding the hardware registers, and a page only partly covered by ROM or RAM - has no
+    // pointers, and is accessed a byte at a time. So is any access straddling two pages.
+    //
+    // RAM is only reserved, not committed, so that the host only provides the pages a program
+    // actually touches, however much RAM it asks for. Its pages, and those of the ROM image, are
+    // entered into the table as they are first accessed. The stacks and QRAM are small, and
+    // always resident.
+    class TM_API Bus
+    {
+    public:
+        using ReadCallback  = std::function<Byte (const Byte& pRegister)>;
+        using WriteCallback = std::function<void (const Byte& pRegister, const Byte& pValue)>;
+
+        static constexpr Index  PAGE_BITS       = 12;
+        static constexpr Index  PAGE_SIZE       = Index { 1 } << PAGE_BITS;
+        static constexpr Index  TABLE_BITS      = 10;
+        static constexpr Index  TABLE_SIZE      = Index { 1 } << TABLE_BITS;
+
+    public:
+        Bus ();
+        ~Bus ();
+        Bus (const Bus&) = delete;
+        Bus& operator= (const Bus&) = delete;
+
+    public:
+        void            AttachROM (const Byte* pData, const Index& pSize);
+        void            AttachProgram (const Byte* pData, const Index& pSize);
+        void            SetRAMSize (const Index& pSize);
+        void            AttachIO (const ReadCallback& pRead, const WriteCallback& pWrite);
+
+    public:
+        template <typename T>
+        inline T Read (const Address& pAddress)
+        {
+            const Page& lPage = GetPage(pAddress);
+            const Index lOffset = pAddress & (PAGE_SIZE - 1);
+
+            T lValue = 0;
+            if (lPage.mRead != nullptr && lOffset <= PAGE_SIZE - sizeof(T))
+            {
+                std::memcpy(&lValue, lPage.mRead + lOffset, sizeof(T));
+            }
+            else
+            {
+                for (Index lIndex = 0; lIndex < sizeof(T); ++lIndex)
+                {
+                    lValue |= static_cast<T>(ReadByte(static_cast<Address>(pAddress + lIndex))) << (lIndex * 8);
+                }
+            }
+
+            return lValue;
+        }
+
+        template <typename T>
+        inline void Write (const Address& pAddress, const T& pValue)
+        {
+            const Page& lPage = GetPage(pAddress);
+            const Index lOffset = pAddress & (PAGE_SIZE - 1);
+
+            if (lPage.mWrite != nullptr && lOffset <= PAGE_SIZE - sizeof(T))
+            {
+                std::memcpy(lPage.mWrite + lOffset, &pValue, sizeof(T));
+            }
+            else
+            {
+                for (Index lIndex = 0; lIndex < sizeof(T); ++lIndex)
+                {
+                    WriteByte(static_cast<Address>(pAddress + lIndex), static_cast<Byte>(pValue >> (lIndex * 8)));
+                }
+            }
+        }
+
+    public:
+        inline const Byte*  GetROM () const { return mROM; }
+        inline Index        GetROMSize () const { return mROMSize; }
+        inline Index        GetRAMSize () const { return mRAMSize; }
+
+    private:
+        struct Page
+        {
+            const Byte*     mRead       = nullptr;
+            Byte*           mWrite      = nullptr;
+        };
+
+        using Table = Array<Page, TABLE_SIZE>;
+
+    private:
+        inline const Page& GetPage (const Address& pAddress) const
+        {
+            return (*mDirectory[pAddress >> (PAGE_BITS + TABLE_BITS)])[(pAddress >> PAGE_BITS) & (TABLE_SIZE - 1)];
+        }
+
+        void            MapRegion (const Address& pStart, const Index& pSize, const Byte* pRead, Byte* pWrite);
+        void            FillRegion (const Address& pStart, const Index& pSize, Table* pShared, const Page& pPage);
+        void            SetPage (const Address& pAddress, const Page& pPage);
+        void            MapDeferredPage (const Address& pAddress);
+        void            ReleaseRAM ();
+        Byte            ReadByte (const Address& pAddress);
+        void            WriteByte (const Address& pAddress, const Byte& pValue);
+
+    private:
+        const Byte*     mROM        = nullptr;
+        Index           mROMSize    = 0;
+        Byte*           mRAM        = nullptr;
+        Index           mRAMSize    = 0;
+        ByteBuffer      mRAMBuffer;                 // Backs RAM where it cannot be reserved.
+        ByteBuffer      mStack;
+        ByteBuffer      mCallStack;
+        ByteBuffer      mQRAM;
+        ReadCallback    mReadIO     = nullptr;
+        WriteCallback   mWriteIO    = nullptr;
+
+        Array<Table*, TABLE_SIZE>   mDirectory  = {};   // Each entry owned, or one of the two below.
+        UniqueList<Table>           mTables;
+        Table                       mUnmapped;          // Of pages not backed by memory.
+        Table                       mDeferred;          // Of ROM and RAM pages not yet accessed.
+        Array<Byte, PAGE_SIZE>      mDiscard    = {};   // Where ignored writes go.
+
+    };
+
+}
@@ -0,0 +1,64 @@
+/// @file TMC.CodeMap.hpp
+
+#pragma once
+
+#include <TMC.Common.hpp>
+
+namespace tmc
+{
+
+    // Tells which ROM bytes hold instructions and which hold data, and where each basic block of
+    // instructions begins.
+    //
+    // The assembler knows both for certain, so an emulator loading the map alongside the ROM may
+    // decode or translate code ahead of time without ever mistaking data for instructions. Ranges
+    // and block leaders are each stored sorted, as delta- and varint-encoded values, and are
+    // decoded whole when the map is opened.
+    class TM_API CodeMap
+    {
+    public:
+        enum class Kind : Uint8
+        {
+            None,       // Not emitted by the assembler; padding or outside the ROM.
+            Code,
+            Data
+        };
+
+        struct Range
+        {
+            Address     mStart      = 0;
+            Long        mSize       = 0;
+            Kind        mKind       = Kind::None;
+        };
+
+    public:
+        static constexpr Long   MAGIC       = 0x4D434D54;   // 'TMCM'
+        static constexpr Long   VERSION     = 1;
+
+    public:
+        CodeMap ();
+        CodeMap (const CodeMap&) = delete;
+        CodeMap& operator= (const CodeMap&) = delete;
+
+    public:
+        void                    AddRange (const Address& pStart, const Long& pSize, const Kind& pKind);
+        void                    AddLeader (const Address& pAddress);
+        void                    Build ();
+        Boolean                 Save (const Path& pPath) const;
+        Boolean                 Open (const Path& pPath);
+        Kind                    Lookup (const Address& pAddress) const;
+        Boolean                 IsLeader (const Address& pAddress) const;
+
+    public:
+        inline const List<Range>&   GetRanges () const { return mRanges; }
+        inline const List<Address>& GetLeaders () const { return mLeaders; }
+        inline Index                GetImageSize () const { return mBuffer.size(); }
+
+    private:
+        List<Range>     mRanges;
+        List<Address>   mLeaders;
+        ByteBuffer      mBuffer;
+
+    };
+
+}
@@ -19,6 +19,12 @@
 
 #define TM_API
 
+#if defined(__GNUC__)
+    #define TM_FORCE_INLINE inline __attribute__((always_inline))
+#else
+    #define TM_FORCE_INLINE inline
+#endif
+
 #define pure = 0
 
 static_assert(std::is_same_v<std::size_t, std::uint64_t>);
@@ -88,6 +94,16 @@ namespace tmc
     constexpr Address   IO_END                              = 0xFFFFFFFF;
     constexpr Address   RAM_END                             = 0xFFFFFFFF;
 
+    constexpr Long      PROGRAM_MAGIC                       = 0x38304D54;
+    constexpr Address   PROGRAM_MAGIC_ADDRESS               = 0x00000000;
+    constexpr Address   PROGRAM_NAME_ADDRESS                = 0x00000004;
+    constexpr Index     PROGRAM_NAME_LENGTH                 = 123;
+    constexpr Address   PROGRAM_AUTHOR_ADDRESS              = 0x00000080;
+    constexpr Index     PROGRAM_AUTHOR_LENGTH               = 127;
+    constexpr Address   PROGRAM_ROM_SIZE_ADDRESS            = 0x00000160;
+    constexpr Address   PROGRAM_RAM_SIZE_ADDRESS            = 0x00000164;
+    constexpr Address   PROGRAM_EXTRA_METADATA_START        = 0x00000168;
+
     template <typename T, typename... As>
     TM_API inline Unique<T> MakeUnique (As&&... pArgs)
     {
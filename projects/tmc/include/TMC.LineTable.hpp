@@ -0,0 +1,64 @@
+/// @file TMC.LineTable.hpp
+
+#pragma once
+
+#include <TMC.Common.hpp>
+
+namespace tmc
+{
+
+    // Maps ROM addresses back to the source lines they were assembled from.
+    //
+    // Rows are grouped into blocks of 'BLOCK_SIZE'. Each block's first row is kept in a fixed-size
+    // index entry, so a lookup binary-searches the index, then decodes at most one block of delta-
+    // and varint-encoded rows. A saved table is used in place, straight from a memory-mapped file.
+    class TM_API LineTable
+    {
+    public:
+        struct Row
+        {
+            Address     mAddress    = 0;
+            Uint32      mFile       = 0;
+            Uint32      mLine       = 0;    // Zero if the address has no source line.
+        };
+
+    public:
+        static constexpr Long   MAGIC       = 0x544C4D54;   // 'TMLT'
+        static constexpr Long   VERSION     = 1;
+        static constexpr Index  BLOCK_SIZE  = 64;
+
+    public:
+        LineTable ();
+        ~LineTable ();
+        LineTable (const LineTable&) = delete;
+        LineTable& operator= (const LineTable&) = delete;
+
+    public:
+        Uint32          AddFile (const String& pFile);
+        void            AddRow (const Address& pAddress, const Uint32& pFile, const Uint32& pLine);
+        void            Build ();
+        Boolean         Save (const Path& pPath) const;
+        Boolean         Open (const Path& pPath);
+        Boolean         Lookup (const Address& pAddress, Row& pRow) const;
+        const Char*     GetFile (const Uint32& pFile) const;
+
+    public:
+        inline Index    GetFileCount () const { return ReadLong(8); }
+        inline Index    GetBlockCount () const { return ReadLong(12); }
+        inline Index    GetImageSize () const { return mImageSize; }
+
+    private:
+        Long            ReadLong (const Index& pOffset) const;
+        void            Close ();
+
+    private:
+        List<String>    mFiles;
+        List<Row>       mRows;
+        ByteBuffer      mBuffer;
+        const Byte*     mImage      = nullptr;
+        Index           mImageSize  = 0;
+        Boolean         mMapped     = false;
+
+    };
+
+}
@@ -0,0 +1,43 @@
+/// @file TMC.MappedFile.hpp
+
+#pragma once
+
+#include <TMC.Common.hpp>
+
+namespace tmc
+{
+
+    // A read-only view of a whole file. On Linux, the file is memory-mapped, so its contents are
+    // only paged in as they are read; elsewhere, it is read into memory up front.
+    class TM_API MappedFile
+    {
+    public:
+        using Ptr = Shared<const MappedFile>;
+
+    public:
+        MappedFile ();
+        ~MappedFile ();
+        MappedFile (const MappedFile&) = delete;
+        MappedFile& operator= (const MappedFile&) = delete;
+
+    public:
+        static Ptr      Open (const Path& pPath);
+
+    public:
+        void            Prefetch () const;
+
+    public:
+        inline const Byte*  GetData () const { return mData; }
+        inline Index        GetSize () const { return mSize; }
+        inline const Path&  GetPath () const { return mPath; }
+
+    private:
+        Path            mPath       = "";
+        const Byte*     mData       = nullptr;
+        Index           mSize       = 0;
+        Boolean         mMapped     = false;
+        ByteBuffer      mBuffer;
+
+    };
+
+}
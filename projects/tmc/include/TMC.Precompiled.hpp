@@ -4,5 +4,6 @@
 #define TMC_PRECOMPILED_HPP
 
 #include <iostream>
+#include <algorithm>
 
 #endif
@@ -0,0 +1,374 @@
+/// @file TMC.Processor.hpp
+
+#pragma once
+
+#include <TMC.Bus.hpp>
+#include <TMC.Scheduler.hpp>
+
+// Threaded dispatch relies on the GNU labels-as-values extension. Any other compiler falls back
+// to the portable 'switch' loop, whatever the build asked for.
+#if defined(TM_THREADED_DISPATCH) && !defined(__GNUC__)
+    #undef TM_THREADED_DISPATCH
+#endif
+
+namespace tmc
+{
+
+    class Recompiler;
+
+    // Executes TM instructions from the ROM attached to a bus.
+    //
+    // Straight-line runs of instructions are decoded once into basic blocks, each ending at a
+    // transfer of control, or at an instruction which halts or stops the processor. Each decoded
+    // instruction's opcode hi byte selects one of 256 handlers, which executes it and returns the
+    // address of the next one. The handler is chosen either by a 'switch' over the hi byte, or -
+    // when built with 'TM_THREADED_DISPATCH' - by jumping from the end of each handler straight
+    // to the next one through a table of labels. A block remembers the blocks which last
+    // followed it, so that hot loops go from block to block without looking any up; pending
+    // interrupts are taken between blocks.
+    //
+    // An arithmetic, bitwise or shift instruction only notes its operands, leaving its condition
+    // flags to be worked out when something reads them: a condition, an instruction taking the
+    // carry in, 'DA*', or a read of 'F'. Most are replaced by the next such instruction first.
+    //
+    // Where a recompiler is available, a block entered often enough is also compiled into host
+    // machine code, which then runs in its place. The execution mode can force every block to be
+    // interpreted or compiled, so that the two can be checked against each other.
+    //
+    // Time is kept in cycles, each instruction costing a fixed number by its opcode. Events
+    // posted to the processor's scheduler fire between blocks, once their time has come. A
+    // halted processor runs no instructions, so its clock skips straight to the next event,
+    // which may wake it; with no events left to wake it, the run ends.
+    //
+    // Register operands use the assembler's numbering, in which bits 2 and 3 select 'A' to 'D',
+    // and bits 0 and 1 select the long register itself, its lo word, or the hi or lo byte of that
+    // word. Where the specification leaves the size of a memory operand open, it is the size of
+    // the register the value is loaded into, added to or stored from; a value reached only
+    // through a pointer register, as in 'INC [X]' or 'SLA [X]', is a byte. Both stacks grow
+    // upwards from the start of their regions, 'SP' and 'RP' holding byte offsets into them.
+    class TM_API Processor
+    {
+    public:
+        static constexpr Byte   FLAG_Z                      = 0x80;
+        static constexpr Byte   FLAG_N                      = 0x40;
+        static constexpr Byte   FLAG_H                      = 0x20;
+        static constexpr Byte   FLAG_C                      = 0x10;
+        static constexpr Byte   FLAG_O                      = 0x08;
+        static constexpr Byte   FLAG_U                      = 0x04;
+        static constexpr Byte   FLAG_HALT                   = 0x02;
+        static constexpr Byte   FLAG_STOP                   = 0x01;
+
+        // Error codes left in 'EC' when the processor stops itself.
+        static constexpr Byte   ERROR_CALL_STACK_EMPTY      = 0x00;
+        static constexpr Byte   ERROR_INVALID_INSTRUCTION   = 0xFE;
+        static constexpr Byte   ERROR_INVALID_FETCH         = 0xFF;
+
+    #if defined(TM_THREADED_DISPATCH)
+        static constexpr const Char*    DISPATCH_NAME       = "threaded";
+    #else
+        static constexpr const Char*    DISPATCH_NAME       = "switch";
+    #endif
+
+        // Counts kept by the block cache over the processor's lifetime, resets included. Each
+        // entry into a block is either chained from the block before it, found by looking it up,
+        // or follows its translation.
+        struct Statistics
+        {
+            Uint64      mBlocksTranslated       = 0;
+            Uint64      mInstructionsTranslated = 0;
+            Uint64      mBlocksEntered          = 0;
+            Uint64      mBlocksChained          = 0;
+            Uint64      mBlocksFound            = 0;
+            Uint64      mInstructionsExecuted   = 0;
+            Uint64      mBlocksRecompiled       = 0;
+            Uint64      mBlocksRunNatively      = 0;
+        };
+
+        // How blocks are run: always by the interpreter; by the interpreter until they have been
+        // entered a number of times, and natively after that; or natively from the outset.
+        enum class ExecutionMode : Uint8
+        {
+            Interpret,
+            Tiered,
+            Recompile
+        };
+
+        static constexpr Uint32 DEFAULT_RECOMPILE_THRESHOLD = 64;
+
+    public:
+        Processor (Bus& pBus);
+        ~Processor ();
+        Processor (const Processor&) = delete;
+        Processor& operator= (const Processor&) = delete;
+
+    public:
+        void            Reset ();
+        Index           Run (const Index& pLimit, const Uint64& pCycleLimit = Scheduler::NEVER);
+        void            RequestInterrupt (const Uint8& pVector);
+        void            SetExecutionMode (const ExecutionMode& pMode,
+                            const Uint32& pThreshold = DEFAULT_RECOMPILE_THRESHOLD);
+
+    public:
+        inline Long     GetRegister (const Uint8& pRegister) const { return ReadRegister(pRegister); }
+        inline void     SetRegister (const Uint8& pRegister, const Long& pValue) { WriteRegister(pRegister, pValue); }
+        inline Byte     GetFlags () const { return EvaluateFlags() | mState; }
+        inline Byte     GetErrorCode () const { return mEC; }
+        inline Address  GetPC () const { return mPC; }
+        inline Word     GetSP () const { return mSP; }
+        inline Word     GetRP () const { return mRP; }
+        inline Boolean  IsInterruptEnabled () const { return mIME; }
+        inline Boolean  IsHalted () const { return (mState & FLAG_HALT) != 0; }
+        inline Boolean  IsStopped () const { return (mState & FLAG_STOP) != 0; }
+        inline Uint64   GetInstructionCount () const { return mInstructionCount; }
+        inline Uint64   GetCycles () const { return mCycles; }
+        inline Scheduler& GetScheduler () { return mScheduler; }
+        inline const Statistics& GetStatistics () const { return mStatistics; }
+        inline ExecutionMode GetExecutionMode () const { return mExecutionMode; }
+
+    private:
+        friend class Recompiler;
+        struct Handlers;
+
+        // A decoded instruction.
+        struct MicroOp
+        {
+            Long        mImmediate      = 0;
+            Byte        mInstruction    = 0;        // The opcode's hi byte.
+            Uint8       mX              = 0;
+            Uint8       mY              = 0;
+            Uint8       mLength         = 0;        // In bytes.
+        };
+
+        using Handler   = Address (*) (Processor& pCPU, const MicroOp& pOp, const Address pPC);
+        using Native    = Address (*) (Processor& pCPU);
+
+        // A straight-line run of decoded instructions, and the blocks which last followed it. The
+        // ROM is never written, so a block stays valid for as long as its image is attached.
+        struct Block
+        {
+            Address             mStart          = 0;
+            List<MicroOp>       mOps;
+            Array<Block*, 2>    mSuccessors     = {};
+            Uint8               mNextSuccessor  = 0;    // The slot to replace on a miss.
+            Uint32              mEntries        = 0;    // Counted until the block is compiled.
+            Uint32              mCycles         = 0;    // Taken by the whole block.
+            Native              mNative         = nullptr;
+        };
+
+        // Blocks are found by their start address through pages of pointers, each allocated when
+        // a block in it is first translated.
+        static constexpr Index  PAGE_SIZE           = 4096;
+        static constexpr Index  MAX_BLOCK_LENGTH    = 256;
+
+        // What the condition flags are to be worked out from: nothing, if 'F' holds them already;
+        // an addition or subtraction of 'mRight' and 'mCarry' from 'mLeft'; or a result, 'mLeft',
+        // whose zero flag is set alongside the flags in 'mRight'.
+        enum class FlagSource : Uint8
+        {
+            None,
+            Add,
+            Subtract,
+            Result
+        };
+
+        struct PendingFlags
+        {
+            FlagSource  mSource         = FlagSource::None;
+            Uint8       mView           = 0;
+            Long        mLeft           = 0;
+            Long        mRight          = 0;
+            Long        mCarry          = 0;
+        };
+
+        using Page      = Array<Block*, PAGE_SIZE>;
+        using PageList  = List<Unique<Page>>;
+        using BlockList = UniqueList<Block>;
+
+        // Per register view: its width in bytes, the shift and mask which extract it from its long
+        // register, and the mask of its lower half, which the half-carry flag watches.
+        static constexpr Array<Index, 4>    VIEW_WIDTHS     = { 4, 2, 1, 1 };
+        static constexpr Array<Index, 4>    VIEW_SHIFTS     = { 0, 0, 8, 0 };
+        static constexpr Array<Long, 4>     VIEW_MASKS      = { 0xFFFFFFFF, 0xFFFF, 0xFF, 0xFF };
+        static constexpr Array<Long, 4>     VIEW_HALVES     = { 0xFFFF, 0xFF, 0xF, 0xF };
+        static constexpr Uint8              VIEW_BYTE       = 3;
+
+        static constexpr Byte               CONDITION_FLAGS = FLAG_Z | FLAG_N | FLAG_H | FLAG_C | FLAG_O | FLAG_U;
+
+    private:
+        inline Long ReadRegister (const Uint8& pRegister) const
+        {
+            const Uint8 lView = pRegister & 0b11;
+            return (mRegisters[(pRegister >> 2) & 0b11] >> VIEW_SHIFTS[lView]) & VIEW_MASKS[lView];
+        }
+
+        inline void WriteRegister (const Uint8& pRegister, const Long& pValue)
+        {
+            const Uint8 lView = pRegister & 0b11;
+            Long& lTarget = mRegisters[(pRegister >> 2) & 0b11];
+            lTarget = (lTarget & ~(VIEW_MASKS[lView] << VIEW_SHIFTS[lView])) |
+                ((pValue & VIEW_MASKS[lView]) << VIEW_SHIFTS[lView]);
+        }
+
+        // As above, for a view known at compile time, given only the long register's index.
+        template <Uint8 V>
+        inline Long ReadView (const Uint8& pIndex) const
+        {
+            return (mRegisters[pIndex] >> VIEW_SHIFTS[V]) & VIEW_MASKS[V];
+        }
+
+        template <Uint8 V>
+        inline void WriteView (const Uint8& pIndex, const Long& pValue)
+        {
+            if constexpr (V == 0)
+            {
+                mRegisters[pIndex] = pValue;
+            }
+            else
+            {
+                Long& lTarget = mRegisters[pIndex];
+                lTarget = (lTarget & ~(VIEW_MASKS[V] << VIEW_SHIFTS[V])) | ((pValue & VIEW_MASKS[V]) << VIEW_SHIFTS[V]);
+            }
+        }
+
+        inline void SetFlags (const Byte& pMask, const Byte& pValue)
+        {
+            // 'F' holds nothing but the condition flags, so replacing all of them needs no read.
+            if (pMask == CONDITION_FLAGS)
+            {
+                mF = pValue;
+                mPendingFlags.mSource = FlagSource::None;
+            }
+            else
+            {
+                mF = static_cast<Byte>((ReadFlags() & ~pMask) | pValue);
+            }
+        }
+
+        inline void DeferFlags (const FlagSource& pSource, const Uint8& pView, const Long& pLeft, const Long& pRight,
+            const Long& pCarry)
+        {
+            mPendingFlags = { pSource, pView, pLeft, pRight, pCarry };
+        }
+
+        inline Byte ReadFlags ()
+        {
+            if (mPendingFlags.mSource != FlagSource::None)
+            {
+                ResolveFlags(*this);
+            }
+
+            return mF;
+        }
+
+        template <Uint8 V>
+        inline Long Load (const Address& pAddress)
+        {
+            if constexpr (VIEW_WIDTHS[V] == 4)          { return mBus.Read<Long>(pAddress); }
+            else if constexpr (VIEW_WIDTHS[V] == 2)     { return mBus.Read<Word>(pAddress); }
+            else                                        { return mBus.Read<Byte>(pAddress); }
+        }
+
+        template <Uint8 V>
+        inline void Store (const Address& pAddress, const Long& pValue)
+        {
+            if constexpr (VIEW_WIDTHS[V] == 4)          { mBus.Write<Long>(pAddress, pValue); }
+            else if constexpr (VIEW_WIDTHS[V] == 2)     { mBus.Write<Word>(pAddress, static_cast<Word>(pValue)); }
+            else                                        { mBus.Write<Byte>(pAddress, static_cast<Byte>(pValue)); }
+        }
+
+        TM_FORCE_INLINE Block* FindBlock (Block* pPrevious, const Address pPC)
+        {
+            // The block just run most likely chains to the next one; failing that, it is looked
+            // up, or translated and then chained.
+            ++mStatistics.mBlocksEntered;
+            if (pPrevious != nullptr)
+            {
+                for (Block* lSuccessor : pPrevious->mSuccessors)
+                {
+                    if (lSuccessor != nullptr && lSuccessor->mStart == pPC)
+                    {
+                        ++mStatistics.mBlocksChained;
+                        return lSuccessor;
+                    }
+                }
+            }
+
+            const Page* lPage = mPages[pPC / PAGE_SIZE].get();
+            Block* lBlock = (lPage != nullptr) ? (*lPage)[pPC % PAGE_SIZE] : nullptr;
+            if (lBlock != nullptr)
+            {
+                ++mStatistics.mBlocksFound;
+            }
+            else
+            {
+                lBlock = Translate(pPC);
+            }
+
+            if (pPrevious != nullptr)
+            {
+                pPrevious->mSuccessors[pPrevious->mNextSuccessor] = lBlock;
+                pPrevious->mNextSuccessor ^= 1;
+            }
+
+            return lBlock;
+        }
+
+        inline Boolean CheckCondition (const Uint8& pCondition)
+        {
+            if (pCondition == 0)
+            {
+                return true;                                    // N
+            }
+
+            const Byte lF = ReadFlags();
+            switch (pCondition)
+            {
+                case 1:     return (lF & FLAG_C) != 0;          // CS
+                case 2:     return (lF & FLAG_C) == 0;          // CC
+                case 3:     return (lF & FLAG_Z) != 0;          // ZS
+                case 4:     return (lF & FLAG_Z) == 0;          // ZC
+                case 5:     return (lF & FLAG_O) != 0;          // OS
+                case 6:     return (lF & FLAG_U) != 0;          // US
+                default:    return false;
+            }
+        }
+
+        static Handler  GetHandler (const Byte& pInstruction);
+        static void     ResolveFlags (Processor& pCPU);
+
+        Byte            EvaluateFlags () const;
+
+        void            Decode (const Address& pPC, MicroOp& pOp);
+        Block*          Translate (const Address& pPC);
+        void            PushCall (const Address& pAddress);
+        Address         PopCall (const Address& pPC);
+        void            ServiceInterrupt ();
+        void            Fault (const Byte& pErrorCode);
+
+    private:
+        Bus&            mBus;
+        const Byte*     mCode               = nullptr;      // The ROM image, as of the last run.
+        Index           mCodeSize           = 0;
+        BlockList       mBlocks;
+        PageList        mPages;                             // Blocks, by ROM page of their start.
+        Unique<Recompiler>  mRecompiler;                    // Created on first use.
+        ExecutionMode   mExecutionMode      = ExecutionMode::Tiered;
+        Uint32          mRecompileThreshold = DEFAULT_RECOMPILE_THRESHOLD;
+        Array<Long, 4>  mRegisters          = {};
+        Byte            mF                  = 0;            // The condition flags of 'F'.
+        PendingFlags    mPendingFlags;                      // Unless resolved into 'mF'.
+        Byte            mState              = 0;            // The halt and stop flags of 'F'.
+        Boolean         mIME                = false;
+        Byte            mEC                 = 0;
+        Address         mPC                 = PROGRAM_START;
+        Word            mSP                 = 0;
+        Word            mRP                 = 0;
+        Word            mPendingInterrupts  = 0;
+        Uint64          mInstructionCount   = 0;
+        Uint64          mCycles             = 0;
+        Scheduler       mScheduler;
+        Statistics      mStatistics;
+
+    };
+
+}
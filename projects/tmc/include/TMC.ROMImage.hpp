@@ -0,0 +1,37 @@
+/// @file TMC.ROMImage.hpp
+
+#pragma once
+
+#include <TMC.MappedFile.hpp>
+
+namespace tmc
+{
+
+    // A program's ROM image, mapped read-only from its file and checked against its own
+    // metadata: the magic number, and the ROM size it declares, which the file must hold. The
+    // image is never copied, so loading it takes the same time whatever its size.
+    class TM_API ROMImage
+    {
+    public:
+        using Ptr = Shared<const ROMImage>;
+
+    public:
+        ROMImage ();
+        ROMImage (const ROMImage&) = delete;
+        ROMImage& operator= (const ROMImage&) = delete;
+
+    public:
+        static Ptr      Load (const Path& pPath);
+
+    public:
+        inline const Byte*  GetData () const { return mFile->GetData(); }
+        inline Index        GetSize () const { return mSize; }
+        inline const Path&  GetPath () const { return mFile->GetPath(); }
+
+    private:
+        MappedFile::Ptr mFile       = nullptr;
+        Index           mSize       = 0;        // As declared by the metadata.
+
+    };
+
+}
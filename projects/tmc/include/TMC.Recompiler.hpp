@@ -0,0 +1,87 @@
+/// @file TMC.Recompiler.hpp
+
+#pragma once
+
+#include <TMC.Processor.hpp>
+
+// Native code is only generated for x86-64 Linux hosts. Elsewhere, every block is interpreted,
+// whatever execution mode is asked for.
+#if defined(TM_LINUX) && defined(__x86_64__)
+    #define TM_RECOMPILER
+#endif
+
+namespace tmc
+{
+
+    // Compiles the processor's basic blocks into x86-64 machine code.
+    //
+    // Within a compiled block, 'A' to 'D' live in 'EAX', 'EBX', 'ECX' and 'EDX', so that every
+    // register view is one of the host's own partial registers - 'AW' is 'AX', 'AH' is 'AH' and
+    // 'AL' is 'AL' - and 'F' lives in 'R14'. Arithmetic, bitwise, shift, move and jump
+    // instructions are translated directly, and the condition flags of each are only worked out
+    // if a later instruction may read them. Any other instruction is run by calling its
+    // interpreter handler, with the registers written back to the processor around the call, and
+    // any flags the handler left pending worked out before 'F' is read back.
+    //
+    // Code is written into one fixed region of executable memory, which is never writable while
+    // any of it may run. Once the region is full, any further block is left to the interpreter.
+    class TM_API Recompiler
+    {
+    public:
+        static constexpr Index  CODE_SIZE           = 64 * 1024 * 1024;
+
+    public:
+        Recompiler (Processor& pCPU);
+        ~Recompiler ();
+        Recompiler (const Recompiler&) = delete;
+        Recompiler& operator= (const Recompiler&) = delete;
+
+    public:
+        Processor::Native   Compile (const Processor::Block& pBlock);
+
+    private:
+        // A host register, as an operand of the given width in bytes. Byte registers 4 to 7 are
+        // 'AH', 'CH', 'DH' and 'BH', so they cannot share an instruction with 'R8' to 'R15'.
+        struct Operand
+        {
+            Uint8       mCode           = 0;
+            Index       mWidth          = 4;
+        };
+
+    private:
+        Boolean         IsNative (const Processor::MicroOp& pOp) const;
+        Operand         GetGuestOperand (const Uint8& pRegister) const;
+        Operand         EmitRightOperand (const Uint8& pRegister, const Index& pWidth);
+
+        void            EmitArithmetic (const Processor::MicroOp& pOp, const Boolean& pFlagsLive);
+        void            EmitShift (const Processor::MicroOp& pOp, const Boolean& pFlagsLive);
+        void            EmitMove (const Processor::MicroOp& pOp);
+        void            EmitJump (const Processor::MicroOp& pOp, const Address& pPC);
+        void            EmitCall (const Processor::MicroOp& pOp, const Address& pPC);
+        void            EmitResolveFlags ();
+
+        void            EmitPrologue ();
+        void            EmitEpilogue ();
+        void            EmitLoadState ();
+        void            EmitStoreState ();
+        void            EmitLoadCarry ();
+        void            EmitZeroExtend (const Uint8& pTarget, const Operand& pSource);
+        void            EmitImmediate (const Long& pValue, const Index& pWidth);
+        void            EmitRegister (std::initializer_list<Byte> pOpcode, const Uint8& pReg, const Uint8& pRM,
+                            const Index& pWidth);
+        void            EmitMemory (std::initializer_list<Byte> pOpcode, const Uint8& pReg, const Int32& pOffset,
+                            const Index& pWidth);
+        void            Emit (std::initializer_list<Byte> pBytes);
+        void            Emit32 (const Long& pValue);
+        void            Emit64 (const Quad& pValue);
+
+    private:
+        Byte*           mCode               = nullptr;
+        Index           mCodeUsed           = 0;
+        ByteBuffer      mBuffer;                            // The block being compiled.
+        Array<Int32, 4> mRegisterOffsets    = {};           // Of 'A' to 'D', within the processor.
+        Int32           mFlagsOffset        = 0;
+
+    };
+
+}
@@ -0,0 +1,61 @@
+/// @file TMC.Scheduler.hpp
+
+#pragma once
+
+#include <TMC.Common.hpp>
+
+namespace tmc
+{
+
+    // Keeps the events posted by timers, devices and other sources of interrupts, in the order
+    // in which they are due, by the processor's cycle count.
+    //
+    // Events are held in a binary min-heap, so that posting one and firing the earliest both take
+    // logarithmic time, and finding when the next is due takes constant time. Events due at the
+    // same time fire in the order they were posted. Cancelling one takes linear time, there
+    // being only ever a handful of event sources.
+    class TM_API Scheduler
+    {
+    public:
+        using EventID   = Uint64;
+        using Callback  = std::function<void (const Uint64& pTime)>;
+
+        static constexpr Uint64 NEVER       = static_cast<Uint64>(-1);
+
+    public:
+        Scheduler ();
+        Scheduler (const Scheduler&) = delete;
+        Scheduler& operator= (const Scheduler&) = delete;
+
+    public:
+        EventID         Schedule (const Uint64& pTime, const Callback& pCallback);
+        void            Cancel (const EventID& pID);
+        void            RunUntil (const Uint64& pTime);
+        void            Clear ();
+
+    public:
+        inline Boolean  IsEmpty () const { return mEvents.empty(); }
+        inline Uint64   GetNextTime () const { return mNextTime; }
+
+    private:
+        struct Event
+        {
+            Uint64      mTime       = 0;
+            EventID     mID         = 0;
+            Callback    mCallback   = nullptr;
+        };
+
+        // Orders the heap so that its front is the earliest event.
+        static Boolean  IsLater (const Event& pLeft, const Event& pRight);
+
+    private:
+        void            UpdateNextTime ();
+
+    private:
+        List<Event>     mEvents;
+        EventID         mNextID     = 0;
+        Uint64          mNextTime   = NEVER;        // Of the earliest event, checked between blocks.
+
+    };
+
+}
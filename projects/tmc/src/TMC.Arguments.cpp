@@ -67,21 +67,45 @@ namespace tmc
         }
     }
 
+    void Arguments::Clear ()
+    {
+        sArguments.clear();
+    }
+
     Boolean Arguments::Has (const String& pKey, const Char& pShort)
     {
         return sArguments.contains(pKey) || sArguments.contains(String { pShort });
     }
 
-    const String& Arguments::Get (const String& pKey, const Char& pShort, const String& pDefault)
+    Index Arguments::Count (const String& pKey, const Char& pShort)
     {
         auto lIter = sArguments.find(pKey);
         if (lIter != sArguments.end() && lIter->second.empty() == false)
+        {
+            return lIter->second.size();
+        }
+
+        auto lShortIter = sArguments.find(String { pShort });
+        if (lShortIter != sArguments.end())
+        {
+            return lShortIter->second.size();
+        }
+
+        return 0;
+    }
+
+    const String& Arguments::Get (const String& pKey, const Char& pShort, const String& pDefault)
+    {
+        // A flag given without a value, as in '--serve', takes the default value.
+        auto lIter = sArguments.find(pKey);
+        if (lIter != sArguments.end() && lIter->second.empty() == false && lIter->second.at(0).empty() == false)
         {
             return lIter->second.at(0);
         }
         
         auto lShortIter = sArguments.find(String { pShort });
-        if (lShortIter != sArguments.end() && lShortIter->second.empty() == false)
+        if (lShortIter != sArguments.end() && lShortIter->second.empty() == false &&
+            lShortIter->second.at(0).empty() == false)
         {
             return lShortIter->second.at(0);
         }
@@ -92,13 +116,14 @@ namespace tmc
     const String& Arguments::Get (const String& pKey, const Char& pShort, const Index& pIndex, const String& pDefault)
     {
         auto lIter = sArguments.find(pKey);
-        if (lIter != sArguments.end() && lIter->second.size() < pIndex)
+        if (lIter != sArguments.end() && lIter->second.size() > pIndex && lIter->second.at(pIndex).empty() == false)
         {
             return lIter->second.at(pIndex);
         }
 
         auto lShortIter = sArguments.find(String { pShort });
-        if (lShortIter != sArguments.end() && lShortIter->second.size() < pIndex)
+        if (lShortIter != sArguments.end() && lShortIter->second.size() > pIndex &&
+            lShortIter->second.at(pIndex).empty() == false)
         {
             return lShortIter->second.at(pIndex);
         }
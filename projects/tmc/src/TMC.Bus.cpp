@@ -0,0 +1,254 @@
+/// @file TMC.Bus.cpp
+
+#include <TMC.Precompiled.hpp>
+#include <TMC.Bus.hpp>
+
+#if defined(TM_LINUX)
+    #include <sys/mman.h>
+#endif
+
+namespace tmc
+{
+
+    /* Static Constants *************************************************************************/
+
+    // Read in place of any page not backed by memory.
+    static constexpr Array<Byte, Bus::PAGE_SIZE> ZERO_PAGE = {};
+
+    /* Public Constructors and Destructor *********************************************************/
+
+    Bus::Bus () :
+        mStack      (STACK_END - STACK_START + 1, 0),
+        mCallStack  (CALL_STACK_END - CALL_STACK_START + 1, 0),
+        mQRAM       (IO_START - QRAM_START, 0)
+    {
+        mUnmapped.fill({ ZERO_PAGE.data(), mDiscard.data() });
+        mDeferred.fill({});
+        mDirectory.fill(&mUnmapped);
+
+        // QRAM's last page is shared with the hardware registers, and so is left unmapped.
+        MapRegion(STACK_START, mStack.size(), mStack.data(), mStack.data());
+        MapRegion(CALL_STACK_START, mCallStack.size(), mCallStack.data(), mCallStack.data());
+        MapRegion(QRAM_START, mQRAM.size(), mQRAM.data(), mQRAM.data());
+    }
+
+    Bus::~Bus ()
+    {
+        ReleaseRAM();
+    }
+
+    /* Public Methods *****************************************************************************/
+
+    void Bus::AttachROM (const Byte* pData, const Index& pSize)
+    {
+        // The ROM image is not copied; it must outlive the bus. Anything past the ROM space is
+        // never visible through it. Like RAM, its pages are only entered into the table as they
+        // are first accessed, so attaching even the largest image costs next to nothing.
+        FillRegion(ROM_START, mROMSize, &mUnmapped, mUnmapped.front());
+
+        mROM = pData;
+        mROMSize = std::min<Index>(pSize, static_cast<Index>(ROM_END) + 1);
+        FillRegion(ROM_START, mROMSize, &mDeferred, mDeferred.front());
+    }
+
+    void Bus::AttachProgram (const Byte* pData, const Index& pSize)
+    {
+        // Programs get exactly the RAM their metadata asks for; an image too short to hold
+        // metadata gets none.
+        Long lRAMSize = 0;
+        if (pSize >= PROGRAM_EXTRA_METADATA_START)
+        {
+            std::memcpy(&lRAMSize, pData + PROGRAM_RAM_SIZE_ADDRESS, sizeof(Long));
+        }
+
+        AttachROM(pData, pSize);
+        SetRAMSize(lRAMSize);
+    }
+
+    void Bus::SetRAMSize (const Index& pSize)
+    {
+        // RAM proper ends where the stacks begin. Every RAM page starts out deferred, and a last
+        // page which is not whole is never entered into the table.
+        FillRegion(RAM_START, mRAMSize, &mUnmapped, mUnmapped.front());
+        ReleaseRAM();
+
+        const Index lSize = std::min<Index>(pSize, STACK_START - RAM_START);
+        if (lSize == 0)
+        {
+            return;
+        }
+
+    #if defined(TM_LINUX)
+        void* lMapping = ::mmap(nullptr, lSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+            -1, 0);
+        if (lMapping == MAP_FAILED)
+        {
+            std::cerr << "[Bus] Could not reserve " << lSize << " bytes of RAM." << std::endl;
+            return;
+        }
+
+        mRAM = static_cast<Byte*>(lMapping);
+    #else
+        mRAMBuffer.assign(lSize, 0);
+        mRAM = mRAMBuffer.data();
+    #endif
+
+        mRAMSize = lSize;
+        FillRegion(RAM_START, mRAMSize, &mDeferred, mDeferred.front());
+    }
+
+    void Bus::AttachIO (const ReadCallback& pRead, const WriteCallback& pWrite)
+    {
+        mReadIO = pRead;
+        mWriteIO = pWrite;
+    }
+
+    /* Private Methods ****************************************************************************/
+
+    void Bus::MapRegion (const Address& pStart, const Index& pSize, const Byte* pRead, Byte* pWrite)
+    {
+        // Every region starts on a page boundary. Writes to a region which cannot be written are
+        // discarded, and a last page the region only partly covers is left to 'ReadByte' and
+        // 'WriteByte'.
+        for (Index lOffset = 0; lOffset < pSize; lOffset += PAGE_SIZE)
+        {
+            Page lPage {};
+            if (pSize - lOffset >= PAGE_SIZE)
+            {
+                lPage.mRead = pRead + lOffset;
+                lPage.mWrite = (pWrite != nullptr) ? pWrite + lOffset : mDiscard.data();
+            }
+
+            SetPage(static_cast<Address>(pStart + lOffset), lPage);
+        }
+    }
+
+    void Bus::FillRegion (const Address& pStart, const Index& pSize, Table* pShared, const Page& pPage)
+    {
+        // Gives every page of a region the same entry. Whole tables in the region are replaced by
+        // the shared table of such entries, so that a large region costs no tables at all.
+        constexpr Index TABLE_SPAN = PAGE_SIZE * TABLE_SIZE;
+        for (Index lOffset = 0; lOffset < pSize;)
+        {
+            const Address lAddress = static_cast<Address>(pStart + lOffset);
+            if (lAddress % TABLE_SPAN == 0 && pSize - lOffset >= TABLE_SPAN)
+            {
+                Table*& lTable = mDirectory[lAddress >> (PAGE_BITS + TABLE_BITS)];
+                std::erase_if(mTables, [&] (const Unique<Table>& pTable) { return pTable.get() == lTable; });
+                lTable = pShared;
+                lOffset += TABLE_SPAN;
+            }
+            else
+            {
+                SetPage(lAddress, pPage);
+                lOffset += PAGE_SIZE;
+            }
+        }
+    }
+
+    void Bus::SetPage (const Address& pAddress, const Page& pPage)
+    {
+        // A table is only allocated once one of its pages differs from the shared table's.
+        Table*& lTable = mDirectory[pAddress >> (PAGE_BITS + TABLE_BITS)];
+        if (lTable == &mUnmapped || lTable == &mDeferred)
+        {
+            lTable = mTables.emplace_back(std::make_unique<Table>(*lTable)).get();
+        }
+
+        (*lTable)[(pAddress >> PAGE_BITS) & (TABLE_SIZE - 1)] = pPage;
+    }
+
+    void Bus::MapDeferredPage (const Address& pAddress)
+    {
+        // Enters the whole ROM or RAM page holding the given address into the table. A last page
+        // which is not whole stays deferred, and is always accessed a byte at a time.
+        if (pAddress < mROMSize)
+        {
+            const Index lOffset = (pAddress - ROM_START) & ~(PAGE_SIZE - 1);
+            if (lOffset + PAGE_SIZE <= mROMSize)
+            {
+                SetPage(static_cast<Address>(ROM_START + lOffset), { mROM + lOffset, mDiscard.data() });
+            }
+        }
+        else if (pAddress >= RAM_START)
+        {
+            const Index lOffset = (pAddress - RAM_START) & ~(PAGE_SIZE - 1);
+            if (lOffset + PAGE_SIZE <= mRAMSize)
+            {
+                SetPage(static_cast<Address>(RAM_START + lOffset), { mRAM + lOffset, mRAM + lOffset });
+            }
+        }
+    }
+
+    void Bus::ReleaseRAM ()
+    {
+    #if defined(TM_LINUX)
+        if (mRAM != nullptr)
+        {
+            ::munmap(mRAM, mRAMSize);
+        }
+    #else
+        mRAMBuffer.clear();
+        mRAMBuffer.shrink_to_fit();
+    #endif
+
+        mRAM = nullptr;
+        mRAMSize = 0;
+    }
+
+    Byte Bus::ReadByte (const Address& pAddress)
+    {
+        const Page& lPage = GetPage(pAddress);
+        if (lPage.mRead != nullptr)
+        {
+            return lPage.mRead[pAddress & (PAGE_SIZE - 1)];
+        }
+        else if (pAddress < mROMSize)
+        {
+            MapDeferredPage(pAddress);
+            return mROM[pAddress];
+        }
+        else if (pAddress >= IO_START)
+        {
+            return (mReadIO != nullptr) ? mReadIO(static_cast<Byte>(pAddress - IO_START)) : 0;
+        }
+        else if (pAddress >= QRAM_START)
+        {
+            return mQRAM[pAddress - QRAM_START];
+        }
+        else if (pAddress >= RAM_START && pAddress - RAM_START < mRAMSize)
+        {
+            MapDeferredPage(pAddress);
+            return mRAM[pAddress - RAM_START];
+        }
+
+        return 0;
+    }
+
+    void Bus::WriteByte (const Address& pAddress, const Byte& pValue)
+    {
+        const Page& lPage = GetPage(pAddress);
+        if (lPage.mWrite != nullptr)
+        {
+            lPage.mWrite[pAddress & (PAGE_SIZE - 1)] = pValue;
+        }
+        else if (pAddress < mROMSize)
+        {
+            MapDeferredPage(pAddress);
+        }
+        else if (pAddress >= IO_START)
+        {
+            if (mWriteIO != nullptr) { mWriteIO(static_cast<Byte>(pAddress - IO_START), pValue); }
+        }
+        else if (pAddress >= QRAM_START)
+        {
+            mQRAM[pAddress - QRAM_START] = pValue;
+        }
+        else if (pAddress >= RAM_START && pAddress - RAM_START < mRAMSize)
+        {
+            MapDeferredPage(pAddress);
+            mRAM[pAddress - RAM_START] = pValue;
+        }
+    }
+
+}
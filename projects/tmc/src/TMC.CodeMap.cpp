@@ -0,0 +1,232 @@
+/// @file TMC.CodeMap.cpp
+
+#include <TMC.Precompiled.hpp>
+#include <TMC.CodeMap.hpp>
+
+namespace tmc
+{
+
+    /* Static Constants ***************************************************************************/
+
+    // Serialized layout, all values little-endian:
+    //
+    //  - Header:       Magic, version, range count and leader count; four longs.
+    //  - Ranges:       Per range, a varint of the gap since the end of the previous range shifted
+    //                  left once, with bit 0 set for code; then a varint of the range's size.
+    //  - Leaders:      Per leader, a varint of the delta from the previous leader.
+    static constexpr Index HEADER_SIZE          = 16;
+
+    /* Static Functions ***************************************************************************/
+
+    static void SetLong (ByteBuffer& pBuffer, const Index& pOffset, const Long& pValue)
+    {
+        for (Index lIndex = 0; lIndex < 4; ++lIndex)
+        {
+            pBuffer[pOffset + lIndex] = static_cast<Byte>((pValue >> (lIndex * 8)) & 0xFF);
+        }
+    }
+
+    static Long GetLong (const ByteBuffer& pBuffer, const Index& pOffset)
+    {
+        return  static_cast<Long>(pBuffer[pOffset]) |
+                (static_cast<Long>(pBuffer[pOffset + 1]) << 8) |
+                (static_cast<Long>(pBuffer[pOffset + 2]) << 16) |
+                (static_cast<Long>(pBuffer[pOffset + 3]) << 24);
+    }
+
+    static void PutVarint (ByteBuffer& pBuffer, Uint64 pValue)
+    {
+        while (pValue >= 0x80)
+        {
+            pBuffer.push_back(static_cast<Byte>(pValue | 0x80));
+            pValue >>= 7;
+        }
+
+        pBuffer.push_back(static_cast<Byte>(pValue));
+    }
+
+    static Boolean GetVarint (const ByteBuffer& pBuffer, Index& pOffset, Uint64& pValue)
+    {
+        pValue = 0;
+        for (Index lShift = 0; pOffset < pBuffer.size() && lShift < 64; lShift += 7)
+        {
+            const Byte lByte = pBuffer[pOffset++];
+            pValue |= static_cast<Uint64>(lByte & 0x7F) << lShift;
+
+            if ((lByte & 0x80) == 0) { return true; }
+        }
+
+        return false;
+    }
+
+    /* Public Constructors and Destructor *********************************************************/
+
+    CodeMap::CodeMap ()
+    {
+
+    }
+
+    /* Public Methods *****************************************************************************/
+
+    void CodeMap::AddRange (const Address& pStart, const Long& pSize, const Kind& pKind)
+    {
+        if (pSize > 0 && pKind != Kind::None)
+        {
+            mRanges.push_back({ pStart, pSize, pKind });
+        }
+    }
+
+    void CodeMap::AddLeader (const Address& pAddress)
+    {
+        mLeaders.push_back(pAddress);
+    }
+
+    void CodeMap::Build ()
+    {
+        // Sort the ranges by address, and join each to the one before it wherever they touch and
+        // are of the same kind.
+        std::stable_sort(mRanges.begin(), mRanges.end(),
+            [] (const Range& pLeft, const Range& pRight) { return pLeft.mStart < pRight.mStart; });
+
+        List<Range> lRanges;
+        lRanges.reserve(mRanges.size());
+        for (const Range& lRange : mRanges)
+        {
+            if (lRanges.empty() == false && lRanges.back().mKind == lRange.mKind &&
+                static_cast<Uint64>(lRanges.back().mStart) + lRanges.back().mSize == lRange.mStart)
+            {
+                lRanges.back().mSize += lRange.mSize;
+                continue;
+            }
+
+            lRanges.push_back(lRange);
+        }
+
+        mRanges = std::move(lRanges);
+
+        std::sort(mLeaders.begin(), mLeaders.end());
+        mLeaders.erase(std::unique(mLeaders.begin(), mLeaders.end()), mLeaders.end());
+
+        mBuffer.assign(HEADER_SIZE, 0);
+        SetLong(mBuffer, 0, MAGIC);
+        SetLong(mBuffer, 4, VERSION);
+        SetLong(mBuffer, 8, static_cast<Long>(mRanges.size()));
+        SetLong(mBuffer, 12, static_cast<Long>(mLeaders.size()));
+
+        Uint64 lEnd = 0;
+        for (const Range& lRange : mRanges)
+        {
+            PutVarint(mBuffer, ((lRange.mStart - lEnd) << 1) | (lRange.mKind == Kind::Code));
+            PutVarint(mBuffer, lRange.mSize);
+            lEnd = static_cast<Uint64>(lRange.mStart) + lRange.mSize;
+        }
+
+        Address lPrevious = 0;
+        for (const Address& lLeader : mLeaders)
+        {
+            PutVarint(mBuffer, lLeader - lPrevious);
+            lPrevious = lLeader;
+        }
+    }
+
+    Boolean CodeMap::Save (const Path& pPath) const
+    {
+        File lFile { pPath, std::ios::out | std::ios::binary | std::ios::trunc };
+        if (lFile.is_open() == false || mBuffer.empty() == true)
+        {
+            std::cerr << "[CodeMap] Could not write code map '" << pPath.string() << "'." << std::endl;
+            return false;
+        }
+
+        lFile.write(reinterpret_cast<const Char*>(mBuffer.data()), static_cast<std::streamsize>(mBuffer.size()));
+        return lFile.good();
+    }
+
+    Boolean CodeMap::Open (const Path& pPath)
+    {
+        mRanges.clear();
+        mLeaders.clear();
+
+        File lFile { pPath, std::ios::in | std::ios::binary };
+        if (lFile.is_open() == false)
+        {
+            std::cerr << "[CodeMap] Could not open code map '" << pPath.string() << "'." << std::endl;
+            return false;
+        }
+
+        mBuffer.assign(std::istreambuf_iterator<Char>(lFile), std::istreambuf_iterator<Char>());
+
+        // Every range and leader takes at least one byte, which bounds the counts in the header
+        // before anything is reserved for them.
+        Boolean lGood = mBuffer.size() >= HEADER_SIZE && GetLong(mBuffer, 0) == MAGIC &&
+            GetLong(mBuffer, 4) == VERSION &&
+            static_cast<Uint64>(GetLong(mBuffer, 8)) * 2 + GetLong(mBuffer, 12) <= mBuffer.size() - HEADER_SIZE;
+
+        Index lOffset = HEADER_SIZE;
+        if (lGood == true)
+        {
+            mRanges.reserve(GetLong(mBuffer, 8));
+            mLeaders.reserve(GetLong(mBuffer, 12));
+        }
+
+        Uint64 lEnd = 0;
+        for (Index lIndex = 0; lGood == true && lIndex < GetLong(mBuffer, 8); ++lIndex)
+        {
+            Uint64 lGap = 0, lSize = 0;
+            lGood = GetVarint(mBuffer, lOffset, lGap) == true && GetVarint(mBuffer, lOffset, lSize) == true &&
+                lEnd + (lGap >> 1) + lSize <= 0x100000000;
+
+            if (lGood == true)
+            {
+                const Address lStart = static_cast<Address>(lEnd + (lGap >> 1));
+                mRanges.push_back({ lStart, static_cast<Long>(lSize), ((lGap & 1) != 0) ? Kind::Code : Kind::Data });
+                lEnd = lStart + lSize;
+            }
+        }
+
+        Uint64 lLeader = 0;
+        for (Index lIndex = 0; lGood == true && lIndex < GetLong(mBuffer, 12); ++lIndex)
+        {
+            Uint64 lDelta = 0;
+            lGood = GetVarint(mBuffer, lOffset, lDelta) == true && lLeader + lDelta <= 0xFFFFFFFF;
+
+            if (lGood == true)
+            {
+                lLeader += lDelta;
+                mLeaders.push_back(static_cast<Address>(lLeader));
+            }
+        }
+
+        if (lGood == false)
+        {
+            std::cerr << "[CodeMap] '" << pPath.string() << "' is not a valid code map." << std::endl;
+            mRanges.clear();
+            mLeaders.clear();
+            mBuffer.clear();
+            return false;
+        }
+
+        return true;
+    }
+
+    CodeMap::Kind CodeMap::Lookup (const Address& pAddress) const
+    {
+        // Find the last range starting at or before the address.
+        auto lIter = std::upper_bound(mRanges.begin(), mRanges.end(), pAddress,
+            [] (const Address& pValue, const Range& pRange) { return pValue < pRange.mStart; });
+
+        if (lIter == mRanges.begin())
+        {
+            return Kind::None;
+        }
+
+        --lIter;
+        return (pAddress - lIter->mStart < lIter->mSize) ? lIter->mKind : Kind::None;
+    }
+
+    Boolean CodeMap::IsLeader (const Address& pAddress) const
+    {
+        return std::binary_search(mLeaders.begin(), mLeaders.end(), pAddress);
+    }
+
+}
@@ -0,0 +1,331 @@
+/// @file TMC.LineTable.cpp
+
+#include <TMC.Precompiled.hpp>
+#include <TMC.LineTable.hpp>
+
+#if defined(TM_LINUX)
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+namespace tmc
+{
+
+    /* Static Constants ***************************************************************************/
+
+    // Serialized layout, all values little-endian:
+    //
+    //  - Header:       Magic, version, file count, block count, file table offset, index offset,
+    //                  data offset and data size; eight longs.
+    //  - File Table:   One long offset per file, followed by the null-terminated file names.
+    //  - Index:        Per block, the first row's address, file and line, then the offset of the
+    //                  block's remaining rows; four longs.
+    //  - Data:         Per row after the first of its block, a varint of the address delta shifted
+    //                  left once, with bit 0 set if the file changes; the new file index, if it
+    //                  does; then the zig-zag encoded line delta.
+    static constexpr Index HEADER_SIZE          = 32;
+    static constexpr Index INDEX_ENTRY_SIZE     = 16;
+
+    /* Static Functions ***************************************************************************/
+
+    static void SetLong (ByteBuffer& pBuffer, const Index& pOffset, const Long& pValue)
+    {
+        for (Index lIndex = 0; lIndex < 4; ++lIndex)
+        {
+            pBuffer[pOffset + lIndex] = static_cast<Byte>((pValue >> (lIndex * 8)) & 0xFF);
+        }
+    }
+
+    static void PutVarint (ByteBuffer& pBuffer, Uint64 pValue)
+    {
+        while (pValue >= 0x80)
+        {
+            pBuffer.push_back(static_cast<Byte>(pValue | 0x80));
+            pValue >>= 7;
+        }
+
+        pBuffer.push_back(static_cast<Byte>(pValue));
+    }
+
+    static Uint64 GetVarint (const Byte* pImage, Index& pOffset, const Index& pEnd)
+    {
+        Uint64 lValue = 0;
+        for (Index lShift = 0; pOffset < pEnd && lShift < 64; lShift += 7)
+        {
+            const Byte lByte = pImage[pOffset++];
+            lValue |= static_cast<Uint64>(lByte & 0x7F) << lShift;
+
+            if ((lByte & 0x80) == 0) { break; }
+        }
+
+        return lValue;
+    }
+
+    /* Public Constructors and Destructor *********************************************************/
+
+    LineTable::LineTable ()
+    {
+
+    }
+
+    LineTable::~LineTable ()
+    {
+        Close();
+    }
+
+    /* Public Methods *****************************************************************************/
+
+    Uint32 LineTable::AddFile (const String& pFile)
+    {
+        mFiles.push_back(pFile);
+        return static_cast<Uint32>(mFiles.size() - 1);
+    }
+
+    void LineTable::AddRow (const Address& pAddress, const Uint32& pFile, const Uint32& pLine)
+    {
+        mRows.push_back({ pAddress, pFile, pLine });
+    }
+
+    void LineTable::Build ()
+    {
+        Close();
+
+        // Sort the rows by address. Where several rows share an address, the last one added
+        // wins; a row which repeats the previous row's location is redundant.
+        std::stable_sort(mRows.begin(), mRows.end(),
+            [] (const Row& pLeft, const Row& pRight) { return pLeft.mAddress < pRight.mAddress; });
+
+        List<Row> lRows;
+        lRows.reserve(mRows.size());
+        for (const Row& lRow : mRows)
+        {
+            if (lRows.empty() == false && lRows.back().mAddress == lRow.mAddress)
+            {
+                lRows.pop_back();
+            }
+
+            if (lRows.empty() == false && lRows.back().mFile == lRow.mFile && lRows.back().mLine == lRow.mLine)
+            {
+                continue;
+            }
+
+            lRows.push_back(lRow);
+        }
+
+        mRows = std::move(lRows);
+
+        const Index lBlockCount = (mRows.size() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+        // Header, patched with the section offsets below.
+        mBuffer.assign(HEADER_SIZE, 0);
+        SetLong(mBuffer, 0, MAGIC);
+        SetLong(mBuffer, 4, VERSION);
+        SetLong(mBuffer, 8, static_cast<Long>(mFiles.size()));
+        SetLong(mBuffer, 12, static_cast<Long>(lBlockCount));
+
+        // File table.
+        const Index lFileTableOffset = mBuffer.size();
+        mBuffer.resize(mBuffer.size() + mFiles.size() * 4, 0);
+        for (Index lFile = 0; lFile < mFiles.size(); ++lFile)
+        {
+            SetLong(mBuffer, lFileTableOffset + lFile * 4, static_cast<Long>(mBuffer.size()));
+            mBuffer.insert(mBuffer.end(), mFiles[lFile].begin(), mFiles[lFile].end());
+            mBuffer.push_back(0);
+        }
+
+        // Index entries, then the rows of each block.
+        const Index lIndexOffset = mBuffer.size();
+        mBuffer.resize(mBuffer.size() + lBlockCount * INDEX_ENTRY_SIZE, 0);
+
+        const Index lDataOffset = mBuffer.size();
+        for (Index lBlock = 0; lBlock < lBlockCount; ++lBlock)
+        {
+            const Index lFirst = lBlock * BLOCK_SIZE;
+            const Index lLast = std::min(lFirst + BLOCK_SIZE, mRows.size());
+            const Index lEntry = lIndexOffset + lBlock * INDEX_ENTRY_SIZE;
+
+            SetLong(mBuffer, lEntry + 0, mRows[lFirst].mAddress);
+            SetLong(mBuffer, lEntry + 4, mRows[lFirst].mFile);
+            SetLong(mBuffer, lEntry + 8, mRows[lFirst].mLine);
+            SetLong(mBuffer, lEntry + 12, static_cast<Long>(mBuffer.size()));
+
+            for (Index lRow = lFirst + 1; lRow < lLast; ++lRow)
+            {
+                const Row& lPrevious = mRows[lRow - 1];
+                const Row& lCurrent = mRows[lRow];
+                const Boolean lFileChanged = lCurrent.mFile != lPrevious.mFile;
+                const Int64 lLineDelta = static_cast<Int64>(lCurrent.mLine) - static_cast<Int64>(lPrevious.mLine);
+
+                PutVarint(mBuffer, (static_cast<Uint64>(lCurrent.mAddress - lPrevious.mAddress) << 1) | lFileChanged);
+                if (lFileChanged == true)
+                {
+                    PutVarint(mBuffer, lCurrent.mFile);
+                }
+
+                PutVarint(mBuffer, (static_cast<Uint64>(lLineDelta) << 1) ^ static_cast<Uint64>(lLineDelta >> 63));
+            }
+        }
+
+        SetLong(mBuffer, 16, static_cast<Long>(lFileTableOffset));
+        SetLong(mBuffer, 20, static_cast<Long>(lIndexOffset));
+        SetLong(mBuffer, 24, static_cast<Long>(lDataOffset));
+        SetLong(mBuffer, 28, static_cast<Long>(mBuffer.size() - lDataOffset));
+
+        mImage = mBuffer.data();
+        mImageSize = mBuffer.size();
+    }
+
+    Boolean LineTable::Save (const Path& pPath) const
+    {
+        File lFile { pPath, std::ios::out | std::ios::binary | std::ios::trunc };
+        if (lFile.is_open() == false || mImage == nullptr)
+        {
+            std::cerr << "[LineTable] Could not write line table '" << pPath.string() << "'." << std::endl;
+            return false;
+        }
+
+        lFile.write(reinterpret_cast<const Char*>(mImage), static_cast<std::streamsize>(mImageSize));
+        return lFile.good();
+    }
+
+    Boolean LineTable::Open (const Path& pPath)
+    {
+        Close();
+
+    #if defined(TM_LINUX)
+        Int32 lFile = ::open(pPath.c_str(), O_RDONLY);
+        struct ::stat lStat {};
+
+        if (lFile >= 0 && ::fstat(lFile, &lStat) == 0 && lStat.st_size > 0)
+        {
+            void* lMapping = ::mmap(nullptr, static_cast<Index>(lStat.st_size), PROT_READ, MAP_PRIVATE, lFile, 0);
+            if (lMapping != MAP_FAILED)
+            {
+                mImage = static_cast<const Byte*>(lMapping);
+                mImageSize = static_cast<Index>(lStat.st_size);
+                mMapped = true;
+            }
+        }
+
+        if (lFile >= 0) { ::close(lFile); }
+    #else
+        File lFile { pPath, std::ios::in | std::ios::binary };
+        if (lFile.is_open() == true)
+        {
+            mBuffer.assign(std::istreambuf_iterator<Char>(lFile), std::istreambuf_iterator<Char>());
+            mImage = mBuffer.data();
+            mImageSize = mBuffer.size();
+        }
+    #endif
+
+        if (mImage == nullptr)
+        {
+            std::cerr << "[LineTable] Could not open line table '" << pPath.string() << "'." << std::endl;
+            return false;
+        }
+
+        // Check that the header is sane before trusting any offset in it.
+        if (mImageSize < HEADER_SIZE || ReadLong(0) != MAGIC || ReadLong(4) != VERSION ||
+            ReadLong(16) + GetFileCount() * 4 > mImageSize ||
+            ReadLong(20) + GetBlockCount() * INDEX_ENTRY_SIZE > mImageSize ||
+            static_cast<Index>(ReadLong(24)) + ReadLong(28) > mImageSize)
+        {
+            std::cerr << "[LineTable] '" << pPath.string() << "' is not a valid line table." << std::endl;
+            Close();
+            return false;
+        }
+
+        return true;
+    }
+
+    Boolean LineTable::Lookup (const Address& pAddress, Row& pRow) const
+    {
+        const Index lBlockCount = (mImage != nullptr) ? GetBlockCount() : 0;
+        const Index lIndexOffset = (mImage != nullptr) ? ReadLong(20) : 0;
+
+        // Find the last block starting at or before the address.
+        Index lLow = 0, lHigh = lBlockCount;
+        while (lLow < lHigh)
+        {
+            const Index lMiddle = lLow + (lHigh - lLow) / 2;
+            if (ReadLong(lIndexOffset + lMiddle * INDEX_ENTRY_SIZE) <= pAddress)    { lLow = lMiddle + 1; }
+            else                                                                    { lHigh = lMiddle; }
+        }
+
+        if (lLow == 0)
+        {
+            return false;
+        }
+
+        // Walk the block's rows up to the address.
+        const Index lEntry = lIndexOffset + (lLow - 1) * INDEX_ENTRY_SIZE;
+        Index lOffset = ReadLong(lEntry + 12);
+        const Index lEnd = (lLow < lBlockCount) ?
+            ReadLong(lEntry + INDEX_ENTRY_SIZE + 12) : static_cast<Index>(ReadLong(24)) + ReadLong(28);
+
+        Row lRow { ReadLong(lEntry), ReadLong(lEntry + 4), ReadLong(lEntry + 8) };
+        while (lOffset < lEnd)
+        {
+            Row lNext = lRow;
+            const Uint64 lAddress = GetVarint(mImage, lOffset, lEnd);
+
+            lNext.mAddress += static_cast<Address>(lAddress >> 1);
+            if ((lAddress & 1) != 0)
+            {
+                lNext.mFile = static_cast<Uint32>(GetVarint(mImage, lOffset, lEnd));
+            }
+
+            const Uint64 lLine = GetVarint(mImage, lOffset, lEnd);
+            lNext.mLine += static_cast<Uint32>(static_cast<Int64>(lLine >> 1) ^ -static_cast<Int64>(lLine & 1));
+
+            if (lNext.mAddress > pAddress) { break; }
+            lRow = lNext;
+        }
+
+        pRow = lRow;
+        return lRow.mLine != 0;
+    }
+
+    const Char* LineTable::GetFile (const Uint32& pFile) const
+    {
+        if (mImage == nullptr || pFile >= GetFileCount())
+        {
+            return "";
+        }
+
+        const Index lOffset = ReadLong(ReadLong(16) + pFile * 4);
+        return (lOffset < mImageSize) ? reinterpret_cast<const Char*>(mImage + lOffset) : "";
+    }
+
+    /* Private Methods ****************************************************************************/
+
+    Long LineTable::ReadLong (const Index& pOffset) const
+    {
+        if (mImage == nullptr || pOffset + 4 > mImageSize)
+        {
+            return 0;
+        }
+
+        return  static_cast<Long>(mImage[pOffset]) |
+                (static_cast<Long>(mImage[pOffset + 1]) << 8) |
+                (static_cast<Long>(mImage[pOffset + 2]) << 16) |
+                (static_cast<Long>(mImage[pOffset + 3]) << 24);
+    }
+
+    void LineTable::Close ()
+    {
+    #if defined(TM_LINUX)
+        if (mMapped == true)
+        {
+            ::munmap(const_cast<Byte*>(mImage), mImageSize);
+        }
+    #endif
+
+        mImage = nullptr;
+        mImageSize = 0;
+        mMapped = false;
+    }
+
+}
@@ -0,0 +1,103 @@
+/// @file TMC.MappedFile.cpp
+
+#include <TMC.Precompiled.hpp>
+#include <TMC.MappedFile.hpp>
+
+#if defined(TM_LINUX)
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+namespace tmc
+{
+
+    /* Public Constructors and Destructor *********************************************************/
+
+    MappedFile::MappedFile ()
+    {
+
+    }
+
+    MappedFile::~MappedFile ()
+    {
+    #if defined(TM_LINUX)
+        if (mMapped == true)
+        {
+            ::munmap(const_cast<Byte*>(mData), mSize);
+        }
+    #endif
+    }
+
+    /* Public Static Methods **********************************************************************/
+
+    MappedFile::Ptr MappedFile::Open (const Path& pPath)
+    {
+        auto lFile = std::make_shared<MappedFile>();
+        lFile->mPath = pPath;
+
+    #if defined(TM_LINUX)
+        Int32 lDescriptor = ::open(pPath.c_str(), O_RDONLY);
+        struct ::stat lStat {};
+
+        if (lDescriptor < 0 || ::fstat(lDescriptor, &lStat) != 0)
+        {
+            if (lDescriptor >= 0) { ::close(lDescriptor); }
+
+            std::cerr << "[MappedFile] Could not open '" << pPath.string() << "'." << std::endl;
+            return nullptr;
+        }
+
+        // An empty file cannot be mapped, but is still a valid, empty view.
+        if (lStat.st_size > 0)
+        {
+            void* lMapping = ::mmap(nullptr, static_cast<Index>(lStat.st_size), PROT_READ, MAP_PRIVATE,
+                lDescriptor, 0);
+            if (lMapping == MAP_FAILED)
+            {
+                ::close(lDescriptor);
+
+                std::cerr << "[MappedFile] Could not map '" << pPath.string() << "'." << std::endl;
+                return nullptr;
+            }
+
+            lFile->mData = static_cast<const Byte*>(lMapping);
+            lFile->mSize = static_cast<Index>(lStat.st_size);
+            lFile->mMapped = true;
+        }
+
+        ::close(lDescriptor);
+    #else
+        File lStream { pPath, std::ios::in | std::ios::binary };
+        if (lStream.is_open() == false)
+        {
+            std::cerr << "[MappedFile] Could not open '" << pPath.string() << "'." << std::endl;
+            return nullptr;
+        }
+
+        lFile->mBuffer.assign(std::istreambuf_iterator<Char>(lStream), std::istreambuf_iterator<Char>());
+        lFile->mData = lFile->mBuffer.data();
+        lFile->mSize = lFile->mBuffer.size();
+    #endif
+
+        return lFile;
+    }
+
+    /* Public Methods *****************************************************************************/
+
+    void MappedFile::Prefetch () const
+    {
+        // Hints that the whole file is about to be read, mostly front to back, so that the kernel
+        // starts reading it in ahead of time. The hints are only advice; a failure is harmless.
+    #if defined(TM_LINUX)
+        if (mMapped == true)
+        {
+            void* lAddress = const_cast<Byte*>(mData);
+            ::madvise(lAddress, mSize, MADV_SEQUENTIAL);
+            ::madvise(lAddress, mSize, MADV_WILLNEED);
+        }
+    #endif
+    }
+
+}
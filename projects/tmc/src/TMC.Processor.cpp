@@ -0,0 +1,1122 @@
+/// @file TMC.Processor.cpp
+
+#include <TMC.Precompiled.hpp>
+#include <TMC.Processor.hpp>
+#include <TMC.Recompiler.hpp>
+
+namespace tmc
+{
+
+    /* Static Constants *************************************************************************/
+
+    // The size of the immediate value following each opcode, by its hi byte. Loads of and
+    // operations on an immediate value take one of the size of the 'X' register's view.
+    static constexpr Index IMMEDIATE_VIEW = NPOS;
+    static constexpr Array<Index, 256> IMMEDIATE_SIZES = [] ()
+    {
+        Array<Index, 256> lSizes {};
+
+        lSizes[0x10] = IMMEDIATE_VIEW;                                      // LD X, I
+        lSizes[0x11] = 4;                                                   // LD X, [A32]
+        lSizes[0x13] = 2;                                                   // LDQ X, [A16]
+        lSizes[0x14] = 1;                                                   // LDH X, [A8]
+        lSizes[0x15] = 4;                                                   // ST [A32], Y
+        lSizes[0x17] = 2;                                                   // STQ [A16], Y
+        lSizes[0x18] = 1;                                                   // STH [A8], Y
+        lSizes[0x20] = 4;                                                   // JMP X, A32
+        lSizes[0x22] = 2;                                                   // JPB X, S16
+        lSizes[0x23] = 4;                                                   // CALL X, A32
+
+        for (Index lOpcode = 0x34; lOpcode <= 0x49; lOpcode += 3)
+        {
+            lSizes[lOpcode] = IMMEDIATE_VIEW;                               // ADD X, I ... CMP X, I
+        }
+
+        return lSizes;
+    } ();
+
+    // Whether anything but the next instruction in the ROM may follow each opcode, by its hi
+    // byte: transfers of control, 'STOP' and 'HALT', and any invalid instruction.
+    static constexpr Array<Boolean, 256> ENDS_BLOCK = [] ()
+    {
+        Array<Boolean, 256> lEnds {};
+        lEnds.fill(true);
+
+        for (Index lOpcode = 0x00; lOpcode <= 0x0A; ++lOpcode)  { lEnds[lOpcode] = false; }
+        for (Index lOpcode = 0x10; lOpcode <= 0x1B; ++lOpcode)  { lEnds[lOpcode] = false; }
+        for (Index lOpcode = 0x30; lOpcode <= 0x4B; ++lOpcode)  { lEnds[lOpcode] = false; }
+        for (Index lOpcode = 0x50; lOpcode <= 0x5D; ++lOpcode)  { lEnds[lOpcode] = false; }
+        for (Index lOpcode = 0x60; lOpcode <= 0x67; ++lOpcode)  { lEnds[lOpcode] = false; }
+
+        lEnds[0x01] = true;                                                 // STOP
+        lEnds[0x02] = true;                                                 // HALT
+        return lEnds;
+    } ();
+
+    // The cycles each instruction takes, by its opcode's hi byte. The specification gives no
+    // timings, so these are nominal: one cycle for any instruction, and one more for each
+    // access to memory or either stack, and for each transfer of control.
+    static constexpr Array<Uint8, 256> CYCLE_COSTS = [] ()
+    {
+        Array<Uint8, 256> lCosts {};
+        lCosts.fill(1);
+
+        for (Index lOpcode = 0x11; lOpcode <= 0x18; ++lOpcode)  { lCosts[lOpcode] = 2; }    // LD ... STH
+        for (Index lOpcode = 0x36; lOpcode <= 0x4B; lOpcode += 3)
+        {
+            lCosts[lOpcode] = 2;                                            // ADD X, [Y] ... CMP X, [Y]
+        }
+
+        for (Index lOpcode = 0x51; lOpcode <= 0x5D; lOpcode += 2)
+        {
+            lCosts[lOpcode] = 3;                                            // SLA [X] ... RRC [X]
+        }
+
+        lCosts[0x1A] = 2;                                                   // PUSH X
+        lCosts[0x1B] = 2;                                                   // POP X
+        lCosts[0x20] = 2;                                                   // JMP X, A32
+        lCosts[0x21] = 2;                                                   // JMP X, [Y]
+        lCosts[0x22] = 2;                                                   // JPB X, S16
+        lCosts[0x23] = 3;                                                   // CALL X, A32
+        lCosts[0x24] = 3;                                                   // RST X
+        lCosts[0x25] = 3;                                                   // RET X
+        lCosts[0x26] = 3;                                                   // RETI
+        lCosts[0x31] = 3;                                                   // INC [Y]
+        lCosts[0x33] = 3;                                                   // DEC [Y]
+        lCosts[0x61] = 2;                                                   // BIT X, [Y]
+        lCosts[0x63] = 3;                                                   // SET X, [Y]
+        lCosts[0x65] = 3;                                                   // RES X, [Y]
+        lCosts[0x67] = 3;                                                   // SWAP [X]
+        lCosts[0xFF] = 2;                                                   // JPS
+        return lCosts;
+    } ();
+
+    /* Static Functions ***************************************************************************/
+
+    static inline Boolean EndsBlock (const Byte& pInstruction, const Uint8& pX)
+    {
+        // 'DA*' and 'CP*' are invalid, and so stop the processor, unless 'X' names a view of 'A'.
+        return ENDS_BLOCK[pInstruction] == true || ((pInstruction == 0x07 || pInstruction == 0x08) && pX > 2);
+    }
+
+    /* Instruction Handlers ***********************************************************************/
+
+    // Every handler takes its operands from the instruction's pre-decoded micro-op: the 'X' and
+    // 'Y' fields of the opcode's lo byte, and the immediate value which follows it, if any.
+    struct Processor::Handlers
+    {
+        enum class Operation : Uint8
+        {
+            Add, Adc, Sub, Sbc, And, Or, Xor, Cmp
+        };
+
+        enum class Shift : Uint8
+        {
+            SLA, SRA, SRL, RL, RLC, RR, RRC, SWAP
+        };
+
+        using FlagSource = Processor::FlagSource;
+
+        // Calls the given template lambda with the register view as its template argument, so
+        // that every handler is compiled once per view, with its widths and masks known.
+        template <typename F>
+        static inline Address ByView (const Uint8& pView, F&& pFunction)
+        {
+            switch (pView & 0b11)
+            {
+                case 0:     return pFunction.template operator()<0>();
+                case 1:     return pFunction.template operator()<1>();
+                case 2:     return pFunction.template operator()<2>();
+                default:    return pFunction.template operator()<3>();
+            }
+        }
+
+        /* Arithmetic and Logic *******************************************************************/
+
+        template <Uint8 V>
+        static inline Long Add (Processor& pCPU, const Long& pLeft, const Long& pRight, const Long& pCarry)
+        {
+            pCPU.DeferFlags(FlagSource::Add, V, pLeft, pRight, pCarry);
+            return (pLeft + pRight + pCarry) & VIEW_MASKS[V];
+        }
+
+        template <Uint8 V>
+        static inline Long Subtract (Processor& pCPU, const Long& pLeft, const Long& pRight, const Long& pBorrow)
+        {
+            pCPU.DeferFlags(FlagSource::Subtract, V, pLeft, pRight, pBorrow);
+            return (pLeft - pRight - pBorrow) & VIEW_MASKS[V];
+        }
+
+        static inline Long GetCarry (Processor& pCPU)
+        {
+            return (pCPU.ReadFlags() & FLAG_C) >> 4;
+        }
+
+        template <Operation O, Uint8 V>
+        static inline Long Calculate (Processor& pCPU, const Long& pLeft, const Long& pRight)
+        {
+            if constexpr (O == Operation::Add)         { return Add<V>(pCPU, pLeft, pRight, 0); }
+            else if constexpr (O == Operation::Adc)    { return Add<V>(pCPU, pLeft, pRight, GetCarry(pCPU)); }
+            else if constexpr (O == Operation::Sub)    { return Subtract<V>(pCPU, pLeft, pRight, 0); }
+            else if constexpr (O == Operation::Sbc)    { return Subtract<V>(pCPU, pLeft, pRight, GetCarry(pCPU)); }
+            else if constexpr (O == Operation::Cmp)    { return Subtract<V>(pCPU, pLeft, pRight, 0); }
+            else
+            {
+                Long lResult = 0;
+                if constexpr (O == Operation::And)      { lResult = pLeft & pRight; }
+                else if constexpr (O == Operation::Or)  { lResult = pLeft | pRight; }
+                else                                    { lResult = pLeft ^ pRight; }
+
+                pCPU.DeferFlags(FlagSource::Result, V, lResult, (O == Operation::And) ? FLAG_H : 0, 0);
+                return lResult;
+            }
+        }
+
+        template <Shift S, Uint8 V>
+        static inline Long ShiftValue (Processor& pCPU, const Long& pValue)
+        {
+            constexpr Long lMask = VIEW_MASKS[V];
+            constexpr Index lBits = VIEW_WIDTHS[V] * 8;
+            const Long lTop = pValue >> (lBits - 1);
+            const Long lBottom = pValue & 1;
+
+            Long lResult = 0, lCarryOut = 0;
+            if constexpr (S == Shift::SLA)          { lResult = pValue << 1;                                    lCarryOut = lTop; }
+            else if constexpr (S == Shift::SRA)     { lResult = (pValue >> 1) | (lTop << (lBits - 1));          lCarryOut = lBottom; }
+            else if constexpr (S == Shift::SRL)     { lResult = pValue >> 1;                                    lCarryOut = lBottom; }
+            else if constexpr (S == Shift::RL)      { lResult = (pValue << 1) | GetCarry(pCPU);                 lCarryOut = lTop; }
+            else if constexpr (S == Shift::RLC)     { lResult = (pValue << 1) | lTop;                           lCarryOut = lTop; }
+            else if constexpr (S == Shift::RR)      { lResult = (pValue >> 1) | (GetCarry(pCPU) << (lBits - 1)); lCarryOut = lBottom; }
+            else if constexpr (S == Shift::RRC)     { lResult = (pValue >> 1) | (lBottom << (lBits - 1));       lCarryOut = lBottom; }
+            else
+            {
+                constexpr Index lHalf = lBits / 2;
+                lResult = ((pValue >> lHalf) | (pValue << lHalf)) & lMask;
+                pCPU.DeferFlags(FlagSource::Result, V, lResult, 0, 0);
+                return lResult;
+            }
+
+            lResult &= lMask;
+            pCPU.DeferFlags(FlagSource::Result, V, lResult, (lCarryOut != 0) ? FLAG_C : 0, 0);
+            return lResult;
+        }
+
+        /* General Instructions *******************************************************************/
+
+        static Address Invalid (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            pCPU.Fault(ERROR_INVALID_INSTRUCTION);
+            return pPC;
+        }
+
+        static Address Nop (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            return pPC + 2;
+        }
+
+        static Address Stop (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            pCPU.mState |= FLAG_STOP;
+            return pPC + 2;
+        }
+
+        static Address Halt (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            pCPU.mState |= FLAG_HALT;
+            return pPC + 2;
+        }
+
+        static Address SetErrorCode (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            pCPU.mEC = static_cast<Byte>((pOp.mX << 4) | pOp.mY);
+            return pPC + 2;
+        }
+
+        static Address ClearErrorCode (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            pCPU.mEC = 0;
+            return pPC + 2;
+        }
+
+        static Address DisableInterrupts (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            pCPU.mIME = false;
+            return pPC + 2;
+        }
+
+        static Address EnableInterrupts (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            pCPU.mIME = true;
+            return pPC + 2;
+        }
+
+        static inline Uint8 GetAccumulator (const MicroOp& pOp)
+        {
+            // 'DAL', 'CPL' and the like name 'A', 'AW' or 'AL' in the 'X' field.
+            constexpr Array<Uint8, 3> ACCUMULATORS = { 0b00, 0b01, 0b11 };
+            return ACCUMULATORS[pOp.mX];
+        }
+
+        static Address DecimalAdjust (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            if (pOp.mX > 2) { return Invalid(pCPU, pOp, pPC); }
+
+            // Each decimal digit above nine is brought back into range, and so is any digit which
+            // the half-carry or carry flag says carried out of, in the direction of the previous
+            // addition or subtraction.
+            const Uint8 lView = GetAccumulator(pOp);
+            const Index lDigits = VIEW_WIDTHS[lView] * 2;
+            const Byte lF = pCPU.ReadFlags();
+            const Boolean lSubtract = (lF & FLAG_N) != 0;
+            Boolean lCarry = (lF & FLAG_C) != 0;
+            Int64 lValue = pCPU.ReadRegister(lView);
+
+            for (Index lDigit = 0; lDigit < lDigits; ++lDigit)
+            {
+                const Uint64 lNibble = (static_cast<Uint64>(lValue) >> (lDigit * 4)) & 0xF;
+                const Boolean lAdjust = lNibble > 9 ||
+                    (lDigit == lDigits / 2 - 1 && (lF & FLAG_H) != 0) ||
+                    (lDigit == lDigits - 1 && lCarry == true);
+
+                if (lAdjust == true)
+                {
+                    lValue += (lSubtract == true) ? -(Int64 { 6 } << (lDigit * 4)) : (Int64 { 6 } << (lDigit * 4));
+                }
+            }
+
+            lCarry = lCarry || lValue < 0 || static_cast<Uint64>(lValue) > VIEW_MASKS[lView];
+
+            const Long lResult = static_cast<Long>(lValue) & VIEW_MASKS[lView];
+            pCPU.WriteRegister(lView, lResult);
+            pCPU.SetFlags(FLAG_Z | FLAG_H | FLAG_C | FLAG_O | FLAG_U,
+                ((lResult == 0) ? FLAG_Z : 0) | ((lCarry == true) ? FLAG_C : 0) |
+                ((lCarry == true) ? ((lSubtract == true) ? FLAG_U : FLAG_O) : 0));
+            return pPC + 2;
+        }
+
+        static Address Complement (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            if (pOp.mX > 2) { return Invalid(pCPU, pOp, pPC); }
+
+            const Uint8 lView = GetAccumulator(pOp);
+            pCPU.WriteRegister(lView, ~pCPU.ReadRegister(lView));
+            pCPU.SetFlags(FLAG_N | FLAG_H, FLAG_N | FLAG_H);
+            return pPC + 2;
+        }
+
+        static Address SetCarry (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            pCPU.SetFlags(FLAG_N | FLAG_H | FLAG_C | FLAG_O | FLAG_U, FLAG_C);
+            return pPC + 2;
+        }
+
+        static Address ComplementCarry (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            pCPU.SetFlags(FLAG_N | FLAG_H | FLAG_C | FLAG_O | FLAG_U, (pCPU.ReadFlags() & FLAG_C) ^ FLAG_C);
+            return pPC + 2;
+        }
+
+        /* Data Transfer Instructions *************************************************************/
+
+        static Address LoadImmediate (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            const Uint8 lX = pOp.mX;
+            return ByView(lX, [&] <Uint8 V> ()
+            {
+                pCPU.WriteView<V>(lX >> 2, pOp.mImmediate);
+                return pPC + 2 + static_cast<Address>(VIEW_WIDTHS[V]);
+            });
+        }
+
+        static Address LoadAbsolute (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            const Uint8 lX = pOp.mX;
+            return ByView(lX, [&] <Uint8 V> ()
+            {
+                pCPU.WriteView<V>(lX >> 2, pCPU.Load<V>(pOp.mImmediate));
+                return pPC + 6;
+            });
+        }
+
+        static Address LoadIndirect (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            const Uint8 lX = pOp.mX;
+            const Address lAddress = pCPU.ReadRegister(pOp.mY);
+            return ByView(lX, [&] <Uint8 V> ()
+            {
+                pCPU.WriteView<V>(lX >> 2, pCPU.Load<V>(lAddress));
+                return pPC + 2;
+            });
+        }
+
+        static Address LoadQuick (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            const Uint8 lX = pOp.mX;
+            const Address lAddress = QRAM_START + pOp.mImmediate;
+            return ByView(lX, [&] <Uint8 V> ()
+            {
+                pCPU.WriteView<V>(lX >> 2, pCPU.Load<V>(lAddress));
+                return pPC + 4;
+            });
+        }
+
+        static Address LoadHardware (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            const Uint8 lX = pOp.mX;
+            const Address lAddress = IO_START + pOp.mImmediate;
+            return ByView(lX, [&] <Uint8 V> ()
+            {
+                pCPU.WriteView<V>(lX >> 2, pCPU.Load<V>(lAddress));
+                return pPC + 3;
+            });
+        }
+
+        static Address StoreAbsolute (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            const Uint8 lY = pOp.mY;
+            const Address lAddress = pOp.mImmediate;
+            return ByView(lY, [&] <Uint8 V> ()
+            {
+                pCPU.Store<V>(lAddress, pCPU.ReadView<V>(lY >> 2));
+                return pPC + 6;
+            });
+        }
+
+        static Address StoreIndirect (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            const Uint8 lY = pOp.mY;
+            const Address lAddress = pCPU.ReadRegister(pOp.mX);
+            return ByView(lY, [&] <Uint8 V> ()
+            {
+                pCPU.Store<V>(lAddress, pCPU.ReadView<V>(lY >> 2));
+                return pPC + 2;
+            });
+        }
+
+        static Address StoreQuick (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            const Uint8 lY = pOp.mY;
+            const Address lAddress = QRAM_START + pOp.mImmediate;
+            return ByView(lY, [&] <Uint8 V> ()
+            {
+                pCPU.Store<V>(lAddress, pCPU.ReadView<V>(lY >> 2));
+                return pPC + 4;
+            });
+        }
+
+        static Address StoreHardware (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            const Uint8 lY = pOp.mY;
+            const Address lAddress = IO_START + pOp.mImmediate;
+            return ByView(lY, [&] <Uint8 V> ()
+            {
+                pCPU.Store<V>(lAddress, pCPU.ReadView<V>(lY >> 2));
+                return pPC + 3;
+            });
+        }
+
+        static Address Move (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            const Uint8 lX = pOp.mX;
+            const Long lValue = pCPU.ReadRegister(pOp.mY);
+            return ByView(lX, [&] <Uint8 V> ()
+            {
+                pCPU.WriteView<V>(lX >> 2, lValue);
+                return pPC + 2;
+            });
+        }
+
+        static Address Push (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            const Uint8 lY = pOp.mY;
+            return ByView(lY, [&] <Uint8 V> ()
+            {
+                pCPU.Store<V>(STACK_START + pCPU.mSP, pCPU.ReadView<V>(lY >> 2));
+                pCPU.mSP += static_cast<Word>(VIEW_WIDTHS[V]);
+                return pPC + 2;
+            });
+        }
+
+        static Address Pop (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            const Uint8 lX = pOp.mX;
+            return ByView(lX, [&] <Uint8 V> ()
+            {
+                pCPU.mSP -= static_cast<Word>(VIEW_WIDTHS[V]);
+                pCPU.WriteView<V>(lX >> 2, pCPU.Load<V>(STACK_START + pCPU.mSP));
+                return pPC + 2;
+            });
+        }
+
+        /* Control Transfer Instructions **********************************************************/
+
+        static Address JumpAbsolute (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            return (pCPU.CheckCondition(pOp.mX) == true) ? pOp.mImmediate : pPC + 6;
+        }
+
+        static Address JumpIndirect (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            return (pCPU.CheckCondition(pOp.mX) == true) ? pCPU.ReadRegister(pOp.mY) : pPC + 2;
+        }
+
+        static Address JumpRelative (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            // The offset is taken from the end of the instruction.
+            const Address lNext = pPC + 4;
+            return (pCPU.CheckCondition(pOp.mX) == true) ?
+                lNext + static_cast<Int16>(pOp.mImmediate) : lNext;
+        }
+
+        static Address Call (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            if (pCPU.CheckCondition(pOp.mX) == false)
+            {
+                return pPC + 6;
+            }
+
+            pCPU.PushCall(pPC + 6);
+            return pOp.mImmediate;
+        }
+
+        static Address Restart (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            pCPU.PushCall(pPC + 2);
+            return RESTART_VECTOR_START + pOp.mX * 0x100;
+        }
+
+        static Address Return (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            return (pCPU.CheckCondition(pOp.mX) == true) ? pCPU.PopCall(pPC) : pPC + 2;
+        }
+
+        static Address ReturnFromInterrupt (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            pCPU.mIME = true;
+            return pCPU.PopCall(pPC);
+        }
+
+        static Address JumpToStart (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            return PROGRAM_START;
+        }
+
+        /* Arithmetic, Bitwise and Comparison Instructions ****************************************/
+
+        template <Operation O>
+        static Address Increment (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            const Uint8 lX = pOp.mX;
+            return ByView(lX, [&] <Uint8 V> ()
+            {
+                const Long lValue = pCPU.ReadView<V>(lX >> 2);
+                pCPU.WriteView<V>(lX >> 2, (O == Operation::Add) ? Add<V>(pCPU, lValue, 1, 0) :
+                    Subtract<V>(pCPU, lValue, 1, 0));
+                return pPC + 2;
+            });
+        }
+
+        template <Operation O>
+        static Address IncrementIndirect (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            const Address lAddress = pCPU.ReadRegister(pOp.mY);
+            const Long lValue = pCPU.Load<VIEW_BYTE>(lAddress);
+            pCPU.Store<VIEW_BYTE>(lAddress, (O == Operation::Add) ? Add<VIEW_BYTE>(pCPU, lValue, 1, 0) :
+                Subtract<VIEW_BYTE>(pCPU, lValue, 1, 0));
+            return pPC + 2;
+        }
+
+        template <Operation O, Uint8 V>
+        static inline void Finish (Processor& pCPU, const Uint8& pIndex, const Long& pRight)
+        {
+            const Long lResult = Calculate<O, V>(pCPU, pCPU.ReadView<V>(pIndex), pRight);
+            if constexpr (O != Operation::Cmp)
+            {
+                pCPU.WriteView<V>(pIndex, lResult);
+            }
+        }
+
+        template <Operation O>
+        static Address OperateImmediate (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            const Uint8 lX = pOp.mX;
+            return ByView(lX, [&] <Uint8 V> ()
+            {
+                Finish<O, V>(pCPU, lX >> 2, pOp.mImmediate);
+                return pPC + 2 + static_cast<Address>(VIEW_WIDTHS[V]);
+            });
+        }
+
+        template <Operation O>
+        static Address OperateRegister (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            const Uint8 lX = pOp.mX;
+            const Long lRight = pCPU.ReadRegister(pOp.mY);
+            return ByView(lX, [&] <Uint8 V> ()
+            {
+                Finish<O, V>(pCPU, lX >> 2, lRight & VIEW_MASKS[V]);
+                return pPC + 2;
+            });
+        }
+
+        template <Operation O>
+        static Address OperateIndirect (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            const Uint8 lX = pOp.mX;
+            const Address lAddress = pCPU.ReadRegister(pOp.mY);
+            return ByView(lX, [&] <Uint8 V> ()
+            {
+                Finish<O, V>(pCPU, lX >> 2, pCPU.Load<V>(lAddress));
+                return pPC + 2;
+            });
+        }
+
+        /* Bit Shifting and Checking Instructions *************************************************/
+
+        template <Shift S>
+        static Address ShiftRegister (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            const Uint8 lX = pOp.mX;
+            return ByView(lX, [&] <Uint8 V> ()
+            {
+                pCPU.WriteView<V>(lX >> 2, ShiftValue<S, V>(pCPU, pCPU.ReadView<V>(lX >> 2)));
+                return pPC + 2;
+            });
+        }
+
+        template <Shift S>
+        static Address ShiftIndirect (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            const Address lAddress = pCPU.ReadRegister(pOp.mY);
+            pCPU.Store<VIEW_BYTE>(lAddress, ShiftValue<S, VIEW_BYTE>(pCPU, pCPU.Load<VIEW_BYTE>(lAddress)));
+            return pPC + 2;
+        }
+
+        static inline Long GetBit (const MicroOp& pOp, const Uint8& pView)
+        {
+            return Long { 1 } << (pOp.mX & (VIEW_WIDTHS[pView] * 8 - 1));
+        }
+
+        static Address TestBit (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            const Uint8 lY = pOp.mY;
+            const Boolean lClear = (pCPU.ReadRegister(lY) & GetBit(pOp, lY & 0b11)) == 0;
+            pCPU.SetFlags(FLAG_Z | FLAG_N | FLAG_H, ((lClear == true) ? FLAG_Z : 0) | FLAG_H);
+            return pPC + 2;
+        }
+
+        static Address TestBitIndirect (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            const Long lValue = pCPU.Load<VIEW_BYTE>(pCPU.ReadRegister(pOp.mY));
+            const Boolean lClear = (lValue & GetBit(pOp, VIEW_BYTE)) == 0;
+            pCPU.SetFlags(FLAG_Z | FLAG_N | FLAG_H, ((lClear == true) ? FLAG_Z : 0) | FLAG_H);
+            return pPC + 2;
+        }
+
+        template <Boolean SET>
+        static Address ChangeBit (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            const Uint8 lY = pOp.mY;
+            const Long lBit = GetBit(pOp, lY & 0b11);
+            pCPU.WriteRegister(lY, (SET == true) ? (pCPU.ReadRegister(lY) | lBit) : (pCPU.ReadRegister(lY) & ~lBit));
+
+            if constexpr (SET == true) { pCPU.SetFlags(FLAG_N | FLAG_H | FLAG_C, FLAG_C); }
+            return pPC + 2;
+        }
+
+        template <Boolean SET>
+        static Address ChangeBitIndirect (Processor& pCPU, const MicroOp& pOp, const Address pPC)
+        {
+            const Address lAddress = pCPU.ReadRegister(pOp.mY);
+            const Long lBit = GetBit(pOp, VIEW_BYTE);
+            const Long lValue = pCPU.Load<VIEW_BYTE>(lAddress);
+            pCPU.Store<VIEW_BYTE>(lAddress, (SET == true) ? (lValue | lBit) : (lValue & ~lBit));
+
+            if constexpr (SET == true) { pCPU.SetFlags(FLAG_N | FLAG_H | FLAG_C, FLAG_C); }
+            return pPC + 2;
+        }
+
+    };
+
+    // Every implemented opcode's hi byte, and its handler. Any other hi byte is invalid.
+    #define TM_INSTRUCTIONS(X)                     \
+        X(0x00, Nop)                               \
+        X(0x01, Stop)                              \
+        X(0x02, Halt)                              \
+        X(0x03, SetErrorCode)                      \
+        X(0x04, ClearErrorCode)                    \
+        X(0x05, DisableInterrupts)                 \
+        X(0x06, EnableInterrupts)                  \
+        X(0x07, DecimalAdjust)                     \
+        X(0x08, Complement)                        \
+        X(0x09, SetCarry)                          \
+        X(0x0A, ComplementCarry)                   \
+        X(0x10, LoadImmediate)                     \
+        X(0x11, LoadAbsolute)                      \
+        X(0x12, LoadIndirect)                      \
+        X(0x13, LoadQuick)                         \
+        X(0x14, LoadHardware)                      \
+        X(0x15, StoreAbsolute)                     \
+        X(0x16, StoreIndirect)                     \
+        X(0x17, StoreQuick)                        \
+        X(0x18, StoreHardware)                     \
+        X(0x19, Move)                              \
+        X(0x1A, Push)                              \
+        X(0x1B, Pop)                               \
+        X(0x20, JumpAbsolute)                      \
+        X(0x21, JumpIndirect)                      \
+        X(0x22, JumpRelative)                      \
+        X(0x23, Call)                              \
+        X(0x24, Restart)                           \
+        X(0x25, Return)                            \
+        X(0x26, ReturnFromInterrupt)               \
+        X(0x30, Increment<Operation::Add>)         \
+        X(0x31, IncrementIndirect<Operation::Add>) \
+        X(0x32, Increment<Operation::Sub>)         \
+        X(0x33, IncrementIndirect<Operation::Sub>) \
+        X(0x34, OperateImmediate<Operation::Add>)  \
+        X(0x35, OperateRegister<Operation::Add>)   \
+        X(0x36, OperateIndirect<Operation::Add>)   \
+        X(0x37, OperateImmediate<Operation::Adc>)  \
+        X(0x38, OperateRegister<Operation::Adc>)   \
+        X(0x39, OperateIndirect<Operation::Adc>)   \
+        X(0x3A, OperateImmediate<Operation::Sub>)  \
+        X(0x3B, OperateRegister<Operation::Sub>)   \
+        X(0x3C, OperateIndirect<Operation::Sub>)   \
+        X(0x3D, OperateImmediate<Operation::Sbc>)  \
+        X(0x3E, OperateRegister<Operation::Sbc>)   \
+        X(0x3F, OperateIndirect<Operation::Sbc>)   \
+        X(0x40, OperateImmediate<Operation::And>)  \
+        X(0x41, OperateRegister<Operation::And>)   \
+        X(0x42, OperateIndirect<Operation::And>)   \
+        X(0x43, OperateImmediate<Operation::Or>)   \
+        X(0x44, OperateRegister<Operation::Or>)    \
+        X(0x45, OperateIndirect<Operation::Or>)    \
+        X(0x46, OperateImmediate<Operation::Xor>)  \
+        X(0x47, OperateRegister<Operation::Xor>)   \
+        X(0x48, OperateIndirect<Operation::Xor>)   \
+        X(0x49, OperateImmediate<Operation::Cmp>)  \
+        X(0x4A, OperateRegister<Operation::Cmp>)   \
+        X(0x4B, OperateIndirect<Operation::Cmp>)   \
+        X(0x50, ShiftRegister<Shift::SLA>)         \
+        X(0x51, ShiftIndirect<Shift::SLA>)         \
+        X(0x52, ShiftRegister<Shift::SRA>)         \
+        X(0x53, ShiftIndirect<Shift::SRA>)         \
+        X(0x54, ShiftRegister<Shift::SRL>)         \
+        X(0x55, ShiftIndirect<Shift::SRL>)         \
+        X(0x56, ShiftRegister<Shift::RL>)          \
+        X(0x57, ShiftIndirect<Shift::RL>)          \
+        X(0x58, ShiftRegister<Shift::RLC>)         \
+        X(0x59, ShiftIndirect<Shift::RLC>)         \
+        X(0x5A, ShiftRegister<Shift::RR>)          \
+        X(0x5B, ShiftIndirect<Shift::RR>)          \
+        X(0x5C, ShiftRegister<Shift::RRC>)         \
+        X(0x5D, ShiftIndirect<Shift::RRC>)         \
+        X(0x60, TestBit)                           \
+        X(0x61, TestBitIndirect)                   \
+        X(0x62, ChangeBit<true>)                   \
+        X(0x63, ChangeBitIndirect<true>)           \
+        X(0x64, ChangeBit<false>)                  \
+        X(0x65, ChangeBitIndirect<false>)          \
+        X(0x66, ShiftRegister<Shift::SWAP>)        \
+        X(0x67, ShiftIndirect<Shift::SWAP>)        \
+        X(0xFF, JumpToStart)
+
+    /* Public Constructors and Destructor *********************************************************/
+
+    Processor::Processor (Bus& pBus) :
+        mBus { pBus }
+    {
+
+    }
+
+    Processor::~Processor ()
+    {
+
+    }
+
+    /* Public Methods *****************************************************************************/
+
+    void Processor::Reset ()
+    {
+        mRegisters          = {};
+        mF                  = 0;
+        mPendingFlags       = {};
+        mState              = 0;
+        mIME                = false;
+        mEC                 = 0;
+        mPC                 = PROGRAM_START;
+        mSP                 = 0;
+        mRP                 = 0;
+        mPendingInterrupts  = 0;
+        mInstructionCount   = 0;
+        mCycles             = 0;
+        mScheduler.Clear();
+    }
+
+    Index Processor::Run (const Index& pLimit, const Uint64& pCycleLimit)
+    {
+        // Runs until either limit is reached, or until the processor stops, or halts with no event
+        // left to wake it. Instructions are only ever fetched from ROM.
+        using Operation = Handlers::Operation;
+        using Shift = Handlers::Shift;
+
+        const Index lLimit = pLimit;
+        const Uint64 lCycleLimit = pCycleLimit;
+        Index lCount = 0;
+
+        // Translated blocks stay valid for as long as the same ROM image stays attached.
+        if (mCode != mBus.GetROM() || mCodeSize != mBus.GetROMSize())
+        {
+            mCode = mBus.GetROM();
+            mCodeSize = mBus.GetROMSize();
+
+            mBlocks.clear();
+            mPages.clear();
+            mPages.resize((mCodeSize + PAGE_SIZE - 1) / PAGE_SIZE);
+            mRecompiler.reset();
+        }
+
+    #if defined(TM_RECOMPILER)
+        if (mExecutionMode != ExecutionMode::Interpret && mRecompiler == nullptr)
+        {
+            mRecompiler = std::make_unique<Recompiler>(*this);
+        }
+    #endif
+
+    #if defined(TM_THREADED_DISPATCH)
+        Array<const void*, 256> lLabels;
+        lLabels.fill(&&lInstructionInvalid);
+
+        #define TM_LABEL(pOpcode, pHandler) lLabels[pOpcode] = &&lInstruction##pOpcode;
+        TM_INSTRUCTIONS(TM_LABEL)
+        #undef TM_LABEL
+    #endif
+
+        // 'PC' is kept in a local while running, and handed from each handler to the next. So is
+        // the cycle count, which is only written back for events to see.
+        Address lPC = mPC;
+        Uint64 lCycles = mCycles;
+        Block* lBlock = nullptr;
+        while (lCount < lLimit && lCycles < lCycleLimit)
+        {
+            if (lCycles >= mScheduler.GetNextTime())
+            {
+                mPC = lPC;
+                mCycles = lCycles;
+                mScheduler.RunUntil(lCycles);
+            }
+
+            if (mPendingInterrupts != 0)
+            {
+                mPC = lPC;
+                ServiceInterrupt();
+                lPC = mPC;
+            }
+
+            if (mState != 0)
+            {
+                // Nothing but an interrupt can wake a halted processor, and only an event can
+                // raise one, so rather than waiting cycle by cycle, the clock is moved on from
+                // each event to the next until one does. The run ends once no event is left due
+                // within the cycle limit; the processor idles until the limit, if there is one.
+                if (mState != FLAG_HALT)
+                {
+                    break;
+                }
+                else if (mScheduler.GetNextTime() >= lCycleLimit)
+                {
+                    if (lCycleLimit != Scheduler::NEVER)
+                    {
+                        lCycles = std::max(lCycles, lCycleLimit);
+                    }
+
+                    break;
+                }
+
+                lCycles = std::max(lCycles, mScheduler.GetNextTime());
+                continue;
+            }
+            else if (static_cast<Index>(lPC) + 2 > mCodeSize)
+            {
+                Fault(ERROR_INVALID_FETCH);
+                break;
+            }
+
+            // Only a block's last instruction can halt or stop the processor, so the checks above
+            // are needed only between blocks. A block is cut short only to meet the limit.
+            lBlock = FindBlock(lBlock, lPC);
+
+        #if defined(TM_RECOMPILER)
+            // A block is compiled once, on the entry after its threshold is reached, and from
+            // then on runs natively whenever the limit allows the whole of it.
+            if (lBlock->mNative == nullptr && mRecompiler != nullptr && lBlock->mEntries++ == mRecompileThreshold)
+            {
+                lBlock->mNative = mRecompiler->Compile(*lBlock);
+                mStatistics.mBlocksRecompiled += (lBlock->mNative != nullptr) ? 1 : 0;
+            }
+
+            if (lBlock->mNative != nullptr && lBlock->mOps.size() <= lLimit - lCount)
+            {
+                ReadFlags();
+                lPC = lBlock->mNative(*this);
+                lCount += lBlock->mOps.size();
+                lCycles += lBlock->mCycles;
+                ++mStatistics.mBlocksRunNatively;
+                continue;
+            }
+        #endif
+
+            const MicroOp* lOp = lBlock->mOps.data();
+            const MicroOp* lEnd = lOp + std::min<Index>(lBlock->mOps.size(), lLimit - lCount);
+            lCount += static_cast<Index>(lEnd - lOp);
+
+            if (lEnd == lOp + lBlock->mOps.size())
+            {
+                lCycles += lBlock->mCycles;
+            }
+            else
+            {
+                for (const MicroOp* lCut = lOp; lCut != lEnd; ++lCut)
+                {
+                    lCycles += CYCLE_COSTS[lCut->mInstruction];
+                }
+            }
+
+        #if defined(TM_THREADED_DISPATCH)
+            // Each handler ends by jumping straight to the next instruction's own, until the end
+            // of the block.
+            goto *lLabels[lOp->mInstruction];
+
+            #define TM_HANDLER(pOpcode, pHandler)                                                   \
+                lInstruction##pOpcode:                                                              \
+                    lPC = Handlers::pHandler(*this, *lOp, lPC);                                     \
+                    if (++lOp != lEnd)                                                              \
+                    {                                                                               \
+                        goto *lLabels[lOp->mInstruction];                                           \
+                    }                                                                               \
+                    continue;
+
+            TM_INSTRUCTIONS(TM_HANDLER)
+            TM_HANDLER(Invalid, Invalid)
+            #undef TM_HANDLER
+        #else
+            for (; lOp != lEnd; ++lOp)
+            {
+                switch (lOp->mInstruction)
+                {
+                    #define TM_HANDLER(pOpcode, pHandler)                                           \
+                        case pOpcode: lPC = Handlers::pHandler(*this, *lOp, lPC); break;
+
+                    TM_INSTRUCTIONS(TM_HANDLER)
+                    #undef TM_HANDLER
+
+                    default: lPC = Handlers::Invalid(*this, *lOp, lPC); break;
+                }
+            }
+        #endif
+        }
+
+        mPC = lPC;
+        mCycles = lCycles;
+        mInstructionCount += lCount;
+        mStatistics.mInstructionsExecuted += lCount;
+        return lCount;
+    }
+
+    void Processor::RequestInterrupt (const Uint8& pVector)
+    {
+        mPendingInterrupts |= static_cast<Word>(1 << (pVector & 0xF));
+    }
+
+    void Processor::SetExecutionMode (const ExecutionMode& pMode, const Uint32& pThreshold)
+    {
+        // Every block not yet compiled starts counting its entries afresh. Blocks already
+        // compiled keep running natively, unless every block is now to be interpreted.
+        mExecutionMode = pMode;
+        mRecompileThreshold = (pMode == ExecutionMode::Recompile) ? 0 : pThreshold;
+
+        for (const Unique<Block>& lBlock : mBlocks)
+        {
+            lBlock->mEntries = 0;
+            if (pMode == ExecutionMode::Interpret)
+            {
+                lBlock->mNative = nullptr;
+            }
+        }
+
+        if (pMode == ExecutionMode::Interpret)
+        {
+            mRecompiler.reset();
+        }
+    }
+
+    /* Private Static Methods *********************************************************************/
+
+    Processor::Handler Processor::GetHandler (const Byte& pInstruction)
+    {
+        using Operation = Handlers::Operation;
+        using Shift = Handlers::Shift;
+
+        switch (pInstruction)
+        {
+            #define TM_HANDLER(pOpcode, pHandler) case pOpcode: return &Handlers::pHandler;
+            TM_INSTRUCTIONS(TM_HANDLER)
+            #undef TM_HANDLER
+
+            default: return &Handlers::Invalid;
+        }
+    }
+
+    void Processor::ResolveFlags (Processor& pCPU)
+    {
+        pCPU.mF = pCPU.EvaluateFlags();
+        pCPU.mPendingFlags.mSource = FlagSource::None;
+    }
+
+    /* Private Methods ****************************************************************************/
+
+    Byte Processor::EvaluateFlags () const
+    {
+        // Exactly the flags the instruction would have set, had they been worked out as it ran.
+        const PendingFlags& lPending = mPendingFlags;
+        const Uint64 lMask = VIEW_MASKS[lPending.mView], lHalf = VIEW_HALVES[lPending.mView];
+        const Uint64 lLeft = lPending.mLeft, lRight = lPending.mRight, lCarry = lPending.mCarry;
+
+        switch (lPending.mSource)
+        {
+            case FlagSource::Add:
+            {
+                const Uint64 lResult = lLeft + lRight + lCarry;
+                return (((lResult & lMask) == 0) ? FLAG_Z : 0) |
+                    (((lLeft & lHalf) + (lRight & lHalf) + lCarry > lHalf) ? FLAG_H : 0) |
+                    ((lResult > lMask) ? (FLAG_C | FLAG_O) : 0);
+            }
+
+            case FlagSource::Subtract:
+            {
+                const Uint64 lResult = lLeft - lRight - lCarry;
+                return (((lResult & lMask) == 0) ? FLAG_Z : 0) | FLAG_N |
+                    (((lLeft & lHalf) < (lRight & lHalf) + lCarry) ? FLAG_H : 0) |
+                    ((lLeft < lRight + lCarry) ? (FLAG_C | FLAG_U) : 0);
+            }
+
+            case FlagSource::Result:
+                return ((lLeft == 0) ? FLAG_Z : 0) | static_cast<Byte>(lRight);
+
+            default:
+                return mF;
+        }
+    }
+
+
+    void Processor::PushCall (const Address& pAddress)
+    {
+        mBus.Write<Long>(CALL_STACK_START + mRP, pAddress);
+        mRP += 4;
+    }
+
+    Address Processor::PopCall (const Address& pPC)
+    {
+        // Returning with nothing on the call stack stops the processor where it is.
+        if (mRP < 4)
+        {
+            Fault(ERROR_CALL_STACK_EMPTY);
+            return pPC;
+        }
+
+        mRP -= 4;
+        return mBus.Read<Long>(CALL_STACK_START + mRP);
+    }
+
+    void Processor::Decode (const Address& pPC, MicroOp& pOp)
+    {
+        const Byte lOperands = mCode[pPC];
+        pOp.mInstruction = mCode[pPC + 1];
+        pOp.mX = lOperands >> 4;
+        pOp.mY = lOperands & 0xF;
+
+        // An immediate value running past the end of the ROM is read through the bus, just as
+        // any other value would be.
+        Index lSize = IMMEDIATE_SIZES[pOp.mInstruction];
+        if (lSize == IMMEDIATE_VIEW)
+        {
+            lSize = VIEW_WIDTHS[pOp.mX & 0b11];
+        }
+
+        pOp.mImmediate = 0;
+        for (Index lIndex = 0; lIndex < lSize; ++lIndex)
+        {
+            pOp.mImmediate |= static_cast<Long>(mBus.Read<Byte>(static_cast<Address>(pPC + 2 + lIndex))) << (lIndex * 8);
+        }
+
+        pOp.mLength = static_cast<Uint8>(2 + lSize);
+    }
+
+    Processor::Block* Processor::Translate (const Address& pPC)
+    {
+        // A block runs up to and including its first instruction which may not be followed by
+        // the next in the ROM, and is cut short at the end of the ROM or at its maximum length.
+        // It always holds at least one instruction, the run loop having checked its fetch.
+        auto lBlock = std::make_unique<Block>();
+        lBlock->mStart = pPC;
+
+        Address lAddress = pPC;
+        while (static_cast<Index>(lAddress) + 2 <= mCodeSize && lBlock->mOps.size() < MAX_BLOCK_LENGTH)
+        {
+            MicroOp& lOp = lBlock->mOps.emplace_back();
+            Decode(lAddress, lOp);
+            lAddress += lOp.mLength;
+            lBlock->mCycles += CYCLE_COSTS[lOp.mInstruction];
+
+            if (EndsBlock(lOp.mInstruction, lOp.mX) == true)
+            {
+                break;
+            }
+        }
+
+        lBlock->mOps.shrink_to_fit();
+        ++mStatistics.mBlocksTranslated;
+        mStatistics.mInstructionsTranslated += lBlock->mOps.size();
+
+        Unique<Page>& lPage = mPages[pPC / PAGE_SIZE];
+        if (lPage == nullptr)
+        {
+            lPage = std::make_unique<Page>();
+        }
+
+        (*lPage)[pPC % PAGE_SIZE] = lBlock.get();
+        mBlocks.push_back(std::move(lBlock));
+        return mBlocks.back().get();
+    }
+
+    void Processor::ServiceInterrupt ()
+    {
+        // A pending interrupt wakes a halted processor, whether or not it is then handled; the
+        // lowest-numbered one is handled first.
+        if ((mState & FLAG_STOP) != 0)
+        {
+            return;
+        }
+
+        mState &= ~FLAG_HALT;
+        if (mIME == false)
+        {
+            return;
+        }
+
+        const Uint8 lVector = static_cast<Uint8>(std::countr_zero(mPendingInterrupts));
+        mPendingInterrupts &= static_cast<Word>(~(1 << lVector));
+        mIME = false;
+
+        PushCall(mPC);
+        mPC = INTERRUPT_VECTOR_START + lVector * 0x100;
+    }
+
+    void Processor::Fault (const Byte& pErrorCode)
+    {
+        mState |= FLAG_STOP;
+        mEC = pErrorCode;
+    }
+
+}
@@ -0,0 +1,60 @@
+/// @file TMC.ROMImage.cpp
+
+#include <TMC.Precompiled.hpp>
+#include <TMC.ROMImage.hpp>
+#include <cstring>
+
+namespace tmc
+{
+
+    /* Public Constructors and Destructor *********************************************************/
+
+    ROMImage::ROMImage ()
+    {
+
+    }
+
+    /* Public Static Methods **********************************************************************/
+
+    ROMImage::Ptr ROMImage::Load (const Path& pPath)
+    {
+        MappedFile::Ptr lFile = MappedFile::Open(pPath);
+        if (lFile == nullptr)
+        {
+            return nullptr;
+        }
+
+        if (lFile->GetSize() < PROGRAM_EXTRA_METADATA_START)
+        {
+            std::cerr << "[ROMImage] '" << pPath.string() << "' is too small to hold program metadata." << std::endl;
+            return nullptr;
+        }
+
+        Long lMagic = 0, lROMSize = 0;
+        std::memcpy(&lMagic, lFile->GetData() + PROGRAM_MAGIC_ADDRESS, sizeof(Long));
+        std::memcpy(&lROMSize, lFile->GetData() + PROGRAM_ROM_SIZE_ADDRESS, sizeof(Long));
+
+        if (lMagic != PROGRAM_MAGIC)
+        {
+            std::cerr << "[ROMImage] '" << pPath.string() << "' is not a TM program: bad magic number 0x" <<
+                std::hex << lMagic << std::dec << "." << std::endl;
+            return nullptr;
+        }
+
+        // Anything in the file past the declared size is not part of the ROM.
+        if (lROMSize < PROGRAM_EXTRA_METADATA_START || lROMSize > lFile->GetSize())
+        {
+            std::cerr << "[ROMImage] '" << pPath.string() << "' declares a ROM size of " << lROMSize <<
+                " bytes, but holds " << lFile->GetSize() << "." << std::endl;
+            return nullptr;
+        }
+
+        lFile->Prefetch();
+
+        auto lImage = std::make_shared<ROMImage>();
+        lImage->mFile = lFile;
+        lImage->mSize = lROMSize;
+        return lImage;
+    }
+
+}
@@ -0,0 +1,630 @@
+/// @file TMC.Recompiler.cpp
+
+#include <TMC.Precompiled.hpp>
+#include <TMC.Recompiler.hpp>
+
+#if defined(TM_RECOMPILER)
+    #include <unistd.h>
+    #include <sys/mman.h>
+#endif
+
+namespace tmc
+{
+
+    /* Static Constants *************************************************************************/
+
+    // Host register numbers, as encoded in instructions.
+    static constexpr Uint8 RAX = 0, RCX = 1, RDX = 2, RBX = 3, RBP = 5, RSI = 6, RDI = 7;
+    static constexpr Uint8 R9 = 9, R10 = 10, R14 = 14, R15 = 15;
+
+    // The host registers holding 'A' to 'D', and 'F'; the processor's address, throughout; and
+    // the scratch registers used to work out flags. Only 'ESI', 'EDI' and 'EBP' may be used
+    // alongside a hi byte register.
+    static constexpr Array<Uint8, 4> GUEST_REGISTERS = { RAX, RBX, RCX, RDX };
+    static constexpr Uint8 FLAGS = R14, CPU = R15;
+    static constexpr Uint8 LEFT = RSI, RIGHT = RDI, RESULT = RBP, CARRY = R9, ZERO = R10;
+
+    // Per arithmetic or bitwise operation, in the order of their opcodes - 'ADD', 'ADC', 'SUB',
+    // 'SBC', 'AND', 'OR', 'XOR' and 'CMP' - the opcode of the host's register form, and the
+    // 'reg' field selecting it in the immediate form.
+    static constexpr Array<Byte, 8> ALU_OPCODES = { 0x00, 0x10, 0x28, 0x18, 0x20, 0x08, 0x30, 0x38 };
+    static constexpr Array<Uint8, 8> ALU_DIGITS = { 0, 2, 5, 3, 4, 1, 6, 7 };
+    static constexpr Uint8 ALU_ADC = 1, ALU_SBC = 3, ALU_AND = 4, ALU_CMP = 7;
+
+    // Per shift, in the order of their opcodes - 'SLA', 'SRA', 'SRL', 'RL', 'RLC', 'RR' and
+    // 'RRC' - the 'reg' field selecting the host's shift or rotate of the same effect.
+    static constexpr Array<Uint8, 7> SHIFT_DIGITS = { 4, 7, 5, 2, 0, 3, 1 };
+    static constexpr Uint8 SHIFT_RL = 3, SHIFT_RR = 5;
+
+    // Per condition code: the flag it tests, and whether the flag must be set. Any condition
+    // beyond 'US' is never met.
+    static constexpr Array<Byte, 7> CONDITION_MASKS = {
+        0, Processor::FLAG_C, Processor::FLAG_C, Processor::FLAG_Z, Processor::FLAG_Z,
+        Processor::FLAG_O, Processor::FLAG_U
+    };
+    static constexpr Array<Boolean, 7> CONDITION_SET = { true, true, false, true, false, true, true };
+
+    /* Static Functions ***************************************************************************/
+
+    static inline Boolean IsArithmetic (const Byte& pInstruction)
+    {
+        // 'INC', 'DEC', and the immediate and register forms of 'ADD' to 'CMP'.
+        return pInstruction == 0x30 || pInstruction == 0x32 ||
+            (pInstruction >= 0x34 && pInstruction <= 0x4A && (pInstruction - 0x34) % 3 != 2);
+    }
+
+    static inline Boolean IsShift (const Byte& pInstruction)
+    {
+        // 'SLA' to 'RRC', and 'SWAP', on a register.
+        return (pInstruction >= 0x50 && pInstruction <= 0x5C && pInstruction % 2 == 0) || pInstruction == 0x66;
+    }
+
+    static inline Boolean DefersFlags (const Byte& pInstruction)
+    {
+        // Any instruction the interpreter leaves to work out its flags later: those above, and
+        // their forms taking an operand from memory.
+        return (pInstruction >= 0x30 && pInstruction <= 0x4B) || (pInstruction >= 0x50 && pInstruction <= 0x5D) ||
+            pInstruction == 0x66 || pInstruction == 0x67;
+    }
+
+    static inline Boolean ReadsCarry (const Byte& pInstruction)
+    {
+        // 'ADC', 'SBC', 'RL' and 'RR', on a register or an immediate value.
+        return pInstruction == 0x37 || pInstruction == 0x38 || pInstruction == 0x3D || pInstruction == 0x3E ||
+            pInstruction == 0x56 || pInstruction == 0x5A;
+    }
+
+    /* Public Constructors and Destructor *********************************************************/
+
+    Recompiler::Recompiler (Processor& pCPU)
+    {
+        const Byte* lBase = reinterpret_cast<const Byte*>(&pCPU);
+        for (Index lIndex = 0; lIndex < mRegisterOffsets.size(); ++lIndex)
+        {
+            mRegisterOffsets[lIndex] = static_cast<Int32>(reinterpret_cast<const Byte*>(&pCPU.mRegisters[lIndex]) - lBase);
+        }
+
+        mFlagsOffset = static_cast<Int32>(reinterpret_cast<const Byte*>(&pCPU.mF) - lBase);
+
+    #if defined(TM_RECOMPILER)
+        void* lMapping = ::mmap(nullptr, CODE_SIZE, PROT_READ | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (lMapping == MAP_FAILED)
+        {
+            std::cerr << "[Recompiler] Could not map memory for native code." << std::endl;
+            return;
+        }
+
+        mCode = static_cast<Byte*>(lMapping);
+    #endif
+    }
+
+    Recompiler::~Recompiler ()
+    {
+    #if defined(TM_RECOMPILER)
+        if (mCode != nullptr)
+        {
+            ::munmap(mCode, CODE_SIZE);
+        }
+    #endif
+    }
+
+    /* Public Methods *****************************************************************************/
+
+    Processor::Native Recompiler::Compile (const Processor::Block& pBlock)
+    {
+        if (mCode == nullptr)
+        {
+            return nullptr;
+        }
+
+        // The condition flags each instruction sets need only be worked out if an instruction
+        // after it may read them before they are set again. Any flag may be read once the block
+        // is left, or by an instruction left to its handler.
+        const List<Processor::MicroOp>& lOps = pBlock.mOps;
+        List<Boolean> lFlagsLive(lOps.size(), true);
+        Byte lLive = Processor::CONDITION_FLAGS;
+
+        for (Index lIndex = lOps.size(); lIndex-- > 0;)
+        {
+            const Processor::MicroOp& lOp = lOps[lIndex];
+            if (IsNative(lOp) == false || lOp.mInstruction == 0x20 || lOp.mInstruction == 0x22)
+            {
+                lLive = Processor::CONDITION_FLAGS;
+            }
+            else if (IsArithmetic(lOp.mInstruction) == true || IsShift(lOp.mInstruction) == true)
+            {
+                lFlagsLive[lIndex] = lLive != 0;
+                lLive = (ReadsCarry(lOp.mInstruction) == true) ? Processor::FLAG_C : 0;
+            }
+        }
+
+        mBuffer.clear();
+        EmitPrologue();
+
+        Address lPC = pBlock.mStart;
+        Boolean lReturned = false;
+        for (Index lIndex = 0; lIndex < lOps.size(); ++lIndex)
+        {
+            const Processor::MicroOp& lOp = lOps[lIndex];
+            const Boolean lLast = lIndex + 1 == lOps.size();
+            const Byte lInstruction = lOp.mInstruction;
+
+            if (IsNative(lOp) == false)
+            {
+                // The handler's own result is the block's, should it be the last instruction.
+                // Otherwise, any flags it left pending are worked out before 'F' is reloaded.
+                EmitCall(lOp, lPC);
+                if (lLast == true)
+                {
+                    lReturned = true;
+                }
+                else
+                {
+                    if (DefersFlags(lInstruction) == true)
+                    {
+                        EmitResolveFlags();
+                    }
+
+                    EmitLoadState();
+                }
+            }
+            else if (lInstruction == 0x20 || lInstruction == 0x22)
+            {
+                EmitJump(lOp, lPC);
+                lReturned = true;
+            }
+            else if (lInstruction == 0x10)
+            {
+                const Operand lX = GetGuestOperand(lOp.mX);
+                if (lX.mWidth == 2) { Emit({ 0x66 }); }
+                Emit({ static_cast<Byte>(((lX.mWidth == 1) ? 0xB0 : 0xB8) + lX.mCode) });
+                EmitImmediate(lOp.mImmediate, lX.mWidth);
+            }
+            else if (lInstruction == 0x19)
+            {
+                EmitMove(lOp);
+            }
+            else if (IsArithmetic(lInstruction) == true)
+            {
+                EmitArithmetic(lOp, lFlagsLive[lIndex]);
+            }
+            else if (IsShift(lInstruction) == true)
+            {
+                EmitShift(lOp, lFlagsLive[lIndex]);
+            }
+
+            lPC += lOp.mLength;
+        }
+
+        // A block cut short at its maximum length, or at the end of the ROM, carries on with the
+        // instruction after its last.
+        if (lReturned == false)
+        {
+            EmitStoreState();
+            Emit({ 0xB8 });
+            Emit32(lPC);
+        }
+
+        EmitEpilogue();
+
+        // Code is copied in with the pages it lands on made writable - and not executable - just
+        // for the duration.
+        const Index lStart = (mCodeUsed + 15) & ~Index { 15 };
+        if (lStart + mBuffer.size() > CODE_SIZE)
+        {
+            return nullptr;
+        }
+
+    #if defined(TM_RECOMPILER)
+        const Index lPageSize = static_cast<Index>(::sysconf(_SC_PAGESIZE));
+        const Index lFirst = lStart & ~(lPageSize - 1);
+        const Index lLength = lStart + mBuffer.size() - lFirst;
+
+        if (::mprotect(mCode + lFirst, lLength, PROT_READ | PROT_WRITE) != 0)
+        {
+            return nullptr;
+        }
+
+        std::memcpy(mCode + lStart, mBuffer.data(), mBuffer.size());
+        if (::mprotect(mCode + lFirst, lLength, PROT_READ | PROT_EXEC) != 0)
+        {
+            std::cerr << "[Recompiler] Could not make native code executable." << std::endl;
+            mCode = nullptr;
+            return nullptr;
+        }
+    #endif
+
+        mCodeUsed = lStart + mBuffer.size();
+        return reinterpret_cast<Processor::Native>(mCode + lStart);
+    }
+
+    /* Private Methods ****************************************************************************/
+
+    Boolean Recompiler::IsNative (const Processor::MicroOp& pOp) const
+    {
+        // 'NOP', 'LD X, I', 'MV', register arithmetic and shifts, 'JMP X, A32' and 'JPB'.
+        const Byte lInstruction = pOp.mInstruction;
+        return lInstruction == 0x00 || lInstruction == 0x10 || lInstruction == 0x19 ||
+            lInstruction == 0x20 || lInstruction == 0x22 ||
+            IsArithmetic(lInstruction) == true || IsShift(lInstruction) == true;
+    }
+
+    Recompiler::Operand Recompiler::GetGuestOperand (const Uint8& pRegister) const
+    {
+        const Uint8 lHost = GUEST_REGISTERS[(pRegister >> 2) & 0b11];
+        switch (pRegister & 0b11)
+        {
+            case 0:     return { lHost, 4 };
+            case 1:     return { lHost, 2 };
+            case 2:     return { static_cast<Uint8>(lHost + 4), 1 };
+            default:    return { lHost, 1 };
+        }
+    }
+
+    Recompiler::Operand Recompiler::EmitRightOperand (const Uint8& pRegister, const Index& pWidth)
+    {
+        // A register as wide as the one it is combined with is used as is, and a wider one is
+        // truncated by naming its lower part; a narrower one is zero-extended into 'EDI'.
+        const Operand lOperand = GetGuestOperand(pRegister);
+        if (lOperand.mWidth >= pWidth)
+        {
+            if (pWidth == 1)
+            {
+                return { (lOperand.mWidth == 1) ? lOperand.mCode : GUEST_REGISTERS[(pRegister >> 2) & 0b11], 1 };
+            }
+
+            return { lOperand.mCode, pWidth };
+        }
+
+        EmitZeroExtend(RIGHT, lOperand);
+        return { RIGHT, pWidth };
+    }
+
+    void Recompiler::EmitArithmetic (const Processor::MicroOp& pOp, const Boolean& pFlagsLive)
+    {
+        // 'INC' and 'DEC' are 'ADD' and 'SUB' of one.
+        const Byte lInstruction = pOp.mInstruction;
+        const Boolean lIncrement = lInstruction == 0x30 || lInstruction == 0x32;
+        const Uint8 lOperation = (lIncrement == true) ? ((lInstruction == 0x30) ? 0 : 2) : (lInstruction - 0x34) / 3;
+        const Boolean lImmediate = lIncrement == true || (lInstruction - 0x34) % 3 == 0;
+        const Long lValue = (lIncrement == true) ? 1 : pOp.mImmediate;
+        const Boolean lBitwise = lOperation >= ALU_AND && lOperation < ALU_CMP;
+
+        const Operand lX = GetGuestOperand(pOp.mX);
+        Operand lRight {};
+        if (lImmediate == false)
+        {
+            lRight = EmitRightOperand(pOp.mY, lX.mWidth);
+        }
+
+        // The half-carry flag is the carry into the upper half of the view, which is bit 4, 8 or
+        // 16 of the two operands and the result, exclusive-ored together.
+        if (pFlagsLive == true && lBitwise == false)
+        {
+            EmitZeroExtend(LEFT, lX);
+            if (lImmediate == true)
+            {
+                Emit({ static_cast<Byte>(0xB8 + RIGHT) });
+                Emit32(lValue);
+            }
+            else if (lRight.mWidth == 1 || lRight.mCode != RIGHT)
+            {
+                EmitZeroExtend(RIGHT, lRight);
+            }
+        }
+
+        if (lOperation == ALU_ADC || lOperation == ALU_SBC)
+        {
+            EmitLoadCarry();
+        }
+
+        if (lImmediate == true)
+        {
+            EmitRegister({ static_cast<Byte>((lX.mWidth == 1) ? 0x80 : 0x81) }, ALU_DIGITS[lOperation], lX.mCode, lX.mWidth);
+            EmitImmediate(lValue, lX.mWidth);
+        }
+        else
+        {
+            EmitRegister({ static_cast<Byte>(ALU_OPCODES[lOperation] + ((lX.mWidth == 1) ? 0 : 1)) }, lRight.mCode,
+                lX.mCode, lX.mWidth);
+        }
+
+        if (pFlagsLive == false)
+        {
+            return;
+        }
+
+        EmitRegister({ 0x0F, 0x94 }, 0, ZERO, 1);                           // SETZ R10B
+        if (lBitwise == true)
+        {
+            EmitRegister({ 0x0F, 0xB6 }, ZERO, ZERO, 4);                    // MOVZX R10D, R10B
+            EmitRegister({ 0xC1 }, 4, ZERO, 4);                             // SHL R10D, 7
+            Emit({ 7 });
+            if (lOperation == ALU_AND)
+            {
+                EmitRegister({ 0x83 }, 1, ZERO, 4);                         // OR R10D, H
+                Emit({ Processor::FLAG_H });
+            }
+
+            EmitRegister({ 0x89 }, ZERO, FLAGS, 4);                         // MOV R14D, R10D
+            return;
+        }
+
+        EmitRegister({ 0x0F, 0x92 }, 0, CARRY, 1);                          // SETC R9B
+        if (lOperation == ALU_CMP)
+        {
+            EmitRegister({ 0x89 }, LEFT, RESULT, 4);                        // MOV EBP, ESI
+            EmitRegister({ 0x29 }, RIGHT, RESULT, 4);                       // SUB EBP, EDI
+        }
+        else
+        {
+            EmitZeroExtend(RESULT, lX);
+        }
+
+        EmitRegister({ 0x31 }, RIGHT, LEFT, 4);                             // XOR ESI, EDI
+        EmitRegister({ 0x31 }, RESULT, LEFT, 4);                            // XOR ESI, EBP
+
+        const Uint8 lHalf = static_cast<Uint8>(lX.mWidth * 4);
+        if (lHalf > 5)
+        {
+            EmitRegister({ 0xC1 }, 5, LEFT, 4);                             // SHR ESI, half - 5
+            Emit({ static_cast<Byte>(lHalf - 5) });
+        }
+        else
+        {
+            EmitRegister({ 0xC1 }, 4, LEFT, 4);                             // SHL ESI, 1
+            Emit({ 1 });
+        }
+
+        EmitRegister({ 0x83 }, 4, LEFT, 4);                                 // AND ESI, H
+        Emit({ Processor::FLAG_H });
+
+        // The carry flag is also the overflow flag of an addition, or the underflow flag of a
+        // subtraction.
+        const Boolean lSubtract = lOperation == 2 || lOperation == ALU_SBC || lOperation == ALU_CMP;
+        EmitRegister({ 0x0F, 0xB6 }, ZERO, ZERO, 4);                        // MOVZX R10D, R10B
+        EmitRegister({ 0xC1 }, 4, ZERO, 4);                                 // SHL R10D, 7
+        Emit({ 7 });
+        EmitRegister({ 0x09 }, LEFT, ZERO, 4);                              // OR R10D, ESI
+        EmitRegister({ 0x0F, 0xB6 }, CARRY, CARRY, 4);                      // MOVZX R9D, R9B
+        EmitRegister({ 0x6B }, CARRY, CARRY, 4);                            // IMUL R9D, R9D, C | O or U
+        Emit({ static_cast<Byte>(Processor::FLAG_C | ((lSubtract == true) ? Processor::FLAG_U : Processor::FLAG_O)) });
+        EmitRegister({ 0x09 }, CARRY, ZERO, 4);                             // OR R10D, R9D
+        if (lSubtract == true)
+        {
+            EmitRegister({ 0x83 }, 1, ZERO, 4);                             // OR R10D, N
+            Emit({ Processor::FLAG_N });
+        }
+
+        EmitRegister({ 0x89 }, ZERO, FLAGS, 4);                             // MOV R14D, R10D
+    }
+
+    void Recompiler::EmitShift (const Processor::MicroOp& pOp, const Boolean& pFlagsLive)
+    {
+        // 'SWAP' rotates by half the view's width, and clears the carry flag.
+        const Operand lX = GetGuestOperand(pOp.mX);
+        const Boolean lSwap = pOp.mInstruction == 0x66;
+        const Uint8 lShift = (pOp.mInstruction - 0x50) / 2;
+        const Byte lWide = (lX.mWidth == 1) ? 0 : 1;
+
+        if (lSwap == true)
+        {
+            EmitRegister({ static_cast<Byte>(0xC0 + lWide) }, 0, lX.mCode, lX.mWidth);  // ROL X, half
+            Emit({ static_cast<Byte>(lX.mWidth * 4) });
+        }
+        else
+        {
+            if (lShift == SHIFT_RL || lShift == SHIFT_RR)
+            {
+                EmitLoadCarry();
+            }
+
+            EmitRegister({ static_cast<Byte>(0xD0 + lWide) }, SHIFT_DIGITS[lShift], lX.mCode, lX.mWidth);
+        }
+
+        if (pFlagsLive == false)
+        {
+            return;
+        }
+
+        // Rotates leave the host's zero flag alone, so the result is tested for it.
+        if (lSwap == false)
+        {
+            EmitRegister({ 0x0F, 0x92 }, 0, CARRY, 1);                      // SETC R9B
+        }
+
+        if (lSwap == true || lShift >= SHIFT_RL)
+        {
+            EmitRegister({ static_cast<Byte>(0x84 + lWide) }, lX.mCode, lX.mCode, lX.mWidth); // TEST X, X
+        }
+
+        EmitRegister({ 0x0F, 0x94 }, 0, ZERO, 1);                           // SETZ R10B
+        EmitRegister({ 0x0F, 0xB6 }, ZERO, ZERO, 4);                        // MOVZX R10D, R10B
+        EmitRegister({ 0xC1 }, 4, ZERO, 4);                                 // SHL R10D, 7
+        Emit({ 7 });
+
+        if (lSwap == false)
+        {
+            EmitRegister({ 0x0F, 0xB6 }, CARRY, CARRY, 4);                  // MOVZX R9D, R9B
+            EmitRegister({ 0xC1 }, 4, CARRY, 4);                            // SHL R9D, 4
+            Emit({ 4 });
+            EmitRegister({ 0x09 }, CARRY, ZERO, 4);                         // OR R10D, R9D
+        }
+
+        EmitRegister({ 0x89 }, ZERO, FLAGS, 4);                             // MOV R14D, R10D
+    }
+
+    void Recompiler::EmitMove (const Processor::MicroOp& pOp)
+    {
+        const Operand lX = GetGuestOperand(pOp.mX);
+        const Operand lY = EmitRightOperand(pOp.mY, lX.mWidth);
+        EmitRegister({ static_cast<Byte>((lX.mWidth == 1) ? 0x88 : 0x89) }, lY.mCode, lX.mCode, lX.mWidth);
+    }
+
+    void Recompiler::EmitJump (const Processor::MicroOp& pOp, const Address& pPC)
+    {
+        // The next address is chosen without a branch: the fall-through address, replaced with
+        // the target if the condition is met.
+        const Address lNext = pPC + pOp.mLength;
+        const Address lTarget = (pOp.mInstruction == 0x20) ? pOp.mImmediate :
+            lNext + static_cast<Int16>(pOp.mImmediate);
+
+        EmitStoreState();
+        if (pOp.mX >= CONDITION_MASKS.size())
+        {
+            Emit({ 0xB8 });                                                 // MOV EAX, next
+            Emit32(lNext);
+        }
+        else if (pOp.mX == 0)
+        {
+            Emit({ 0xB8 });                                                 // MOV EAX, target
+            Emit32(lTarget);
+        }
+        else
+        {
+            Emit({ 0xB8 });                                                 // MOV EAX, next
+            Emit32(lNext);
+            Emit({ static_cast<Byte>(0xB8 + RSI) });                        // MOV ESI, target
+            Emit32(lTarget);
+            EmitRegister({ 0xF7 }, 0, FLAGS, 4);                            // TEST R14D, mask
+            Emit32(CONDITION_MASKS[pOp.mX]);
+            EmitRegister({ 0x0F, static_cast<Byte>((CONDITION_SET[pOp.mX] == true) ? 0x45 : 0x44) }, RAX, RSI, 4);
+        }
+    }
+
+    void Recompiler::EmitCall (const Processor::MicroOp& pOp, const Address& pPC)
+    {
+        // The handler sees the processor as the interpreter would, and its result is left in
+        // 'EAX'.
+        EmitStoreState();
+        EmitRegister({ 0x89 }, CPU, RDI, 8);                                // MOV RDI, R15
+        Emit({ 0x48, static_cast<Byte>(0xB8 + RSI) });                      // MOV RSI, op
+        Emit64(reinterpret_cast<Quad>(&pOp));
+        Emit({ static_cast<Byte>(0xB8 + RDX) });                            // MOV EDX, PC
+        Emit32(pPC);
+        Emit({ 0x48, static_cast<Byte>(0xB8 + RAX) });                      // MOV RAX, handler
+        Emit64(reinterpret_cast<Quad>(Processor::GetHandler(pOp.mInstruction)));
+        Emit({ 0xFF, 0xD0 });                                               // CALL RAX
+    }
+
+    void Recompiler::EmitResolveFlags ()
+    {
+        EmitRegister({ 0x89 }, CPU, RDI, 8);                                // MOV RDI, R15
+        Emit({ 0x48, static_cast<Byte>(0xB8 + RAX) });                      // MOV RAX, resolver
+        Emit64(reinterpret_cast<Quad>(&Processor::ResolveFlags));
+        Emit({ 0xFF, 0xD0 });                                               // CALL RAX
+    }
+
+    void Recompiler::EmitPrologue ()
+    {
+        // Four pushes and the return address leave the stack eight bytes short of the alignment
+        // a call needs.
+        Emit({ 0x53, 0x55, 0x41, 0x56, 0x41, 0x57 });                       // PUSH RBX, RBP, R14, R15
+        Emit({ 0x48, 0x83, 0xEC, 0x08 });                                   // SUB RSP, 8
+        EmitRegister({ 0x89 }, RDI, CPU, 8);                                // MOV R15, RDI
+        EmitLoadState();
+    }
+
+    void Recompiler::EmitEpilogue ()
+    {
+        Emit({ 0x48, 0x83, 0xC4, 0x08 });                                   // ADD RSP, 8
+        Emit({ 0x41, 0x5F, 0x41, 0x5E, 0x5D, 0x5B });                       // POP R15, R14, RBP, RBX
+        Emit({ 0xC3 });                                                     // RET
+    }
+
+    void Recompiler::EmitLoadState ()
+    {
+        for (Index lIndex = 0; lIndex < GUEST_REGISTERS.size(); ++lIndex)
+        {
+            EmitMemory({ 0x8B }, GUEST_REGISTERS[lIndex], mRegisterOffsets[lIndex], 4);
+        }
+
+        EmitMemory({ 0x0F, 0xB6 }, FLAGS, mFlagsOffset, 4);
+    }
+
+    void Recompiler::EmitStoreState ()
+    {
+        for (Index lIndex = 0; lIndex < GUEST_REGISTERS.size(); ++lIndex)
+        {
+            EmitMemory({ 0x89 }, GUEST_REGISTERS[lIndex], mRegisterOffsets[lIndex], 4);
+        }
+
+        EmitMemory({ 0x88 }, FLAGS, mFlagsOffset, 1);
+    }
+
+    void Recompiler::EmitLoadCarry ()
+    {
+        EmitRegister({ 0x0F, 0xBA }, 4, FLAGS, 4);                          // BT R14D, 4
+        Emit({ static_cast<Byte>(std::countr_zero(Processor::FLAG_C)) });
+    }
+
+    void Recompiler::EmitZeroExtend (const Uint8& pTarget, const Operand& pSource)
+    {
+        switch (pSource.mWidth)
+        {
+            case 4:     EmitRegister({ 0x89 }, pSource.mCode, pTarget, 4); break;
+            case 2:     EmitRegister({ 0x0F, 0xB7 }, pTarget, pSource.mCode, 4); break;
+            default:    EmitRegister({ 0x0F, 0xB6 }, pTarget, pSource.mCode, 4); break;
+        }
+    }
+
+    void Recompiler::EmitImmediate (const Long& pValue, const Index& pWidth)
+    {
+        for (Index lIndex = 0; lIndex < pWidth; ++lIndex)
+        {
+            mBuffer.push_back(static_cast<Byte>(pValue >> (lIndex * 8)));
+        }
+    }
+
+    void Recompiler::EmitRegister (std::initializer_list<Byte> pOpcode, const Uint8& pReg, const Uint8& pRM,
+        const Index& pWidth)
+    {
+        if (pWidth == 2)
+        {
+            Emit({ 0x66 });
+        }
+
+        const Byte lRex = ((pWidth == 8) ? 0x08 : 0) | ((pReg >= 8) ? 0x04 : 0) | ((pRM >= 8) ? 0x01 : 0);
+        if (lRex != 0)
+        {
+            Emit({ static_cast<Byte>(0x40 | lRex) });
+        }
+
+        Emit(pOpcode);
+        Emit({ static_cast<Byte>(0xC0 | ((pReg & 0b111) << 3) | (pRM & 0b111)) });
+    }
+
+    void Recompiler::EmitMemory (std::initializer_list<Byte> pOpcode, const Uint8& pReg, const Int32& pOffset,
+        const Index& pWidth)
+    {
+        // The operand is '[R15 + offset]', with a 32-bit displacement.
+        if (pWidth == 2)
+        {
+            Emit({ 0x66 });
+        }
+
+        Emit({ static_cast<Byte>(0x41 | ((pWidth == 8) ? 0x08 : 0) | ((pReg >= 8) ? 0x04 : 0)) });
+        Emit(pOpcode);
+        Emit({ static_cast<Byte>(0x80 | ((pReg & 0b111) << 3) | (CPU & 0b111)) });
+        Emit32(static_cast<Long>(pOffset));
+    }
+
+    void Recompiler::Emit (std::initializer_list<Byte> pBytes)
+    {
+        mBuffer.insert(mBuffer.end(), pBytes);
+    }
+
+    void Recompiler::Emit32 (const Long& pValue)
+    {
+        EmitImmediate(pValue, 4);
+    }
+
+    void Recompiler::Emit64 (const Quad& pValue)
+    {
+        for (Index lIndex = 0; lIndex < 8; ++lIndex)
+        {
+            mBuffer.push_back(static_cast<Byte>(pValue >> (lIndex * 8)));
+        }
+    }
+
+}
@@ -0,0 +1,75 @@
+/// @file TMC.Scheduler.cpp
+
+#include <TMC.Precompiled.hpp>
+#include <TMC.Scheduler.hpp>
+
+namespace tmc
+{
+
+    /* Public Constructors and Destructor *********************************************************/
+
+    Scheduler::Scheduler ()
+    {
+
+    }
+
+    /* Public Methods *****************************************************************************/
+
+    Scheduler::EventID Scheduler::Schedule (const Uint64& pTime, const Callback& pCallback)
+    {
+        const EventID lID = mNextID++;
+        mEvents.push_back({ pTime, lID, pCallback });
+        std::push_heap(mEvents.begin(), mEvents.end(), IsLater);
+        UpdateNextTime();
+        return lID;
+    }
+
+    void Scheduler::Cancel (const EventID& pID)
+    {
+        // An event which has already fired, or was never posted, is ignored.
+        const auto lIterator = std::find_if(mEvents.begin(), mEvents.end(),
+            [&] (const Event& pEvent) { return pEvent.mID == pID; });
+        if (lIterator != mEvents.end())
+        {
+            mEvents.erase(lIterator);
+            std::make_heap(mEvents.begin(), mEvents.end(), IsLater);
+            UpdateNextTime();
+        }
+    }
+
+    void Scheduler::RunUntil (const Uint64& pTime)
+    {
+        // Each event is taken off the heap before it fires, so that its callback may post or
+        // cancel others - including ones due at once, which fire in this same call.
+        while (mEvents.empty() == false && mEvents.front().mTime <= pTime)
+        {
+            std::pop_heap(mEvents.begin(), mEvents.end(), IsLater);
+            const Event lEvent = std::move(mEvents.back());
+            mEvents.pop_back();
+            UpdateNextTime();
+
+            lEvent.mCallback(lEvent.mTime);
+        }
+    }
+
+    void Scheduler::Clear ()
+    {
+        mEvents.clear();
+        UpdateNextTime();
+    }
+
+    /* Private Static Methods *********************************************************************/
+
+    Boolean Scheduler::IsLater (const Event& pLeft, const Event& pRight)
+    {
+        return (pLeft.mTime != pRight.mTime) ? pLeft.mTime > pRight.mTime : pLeft.mID > pRight.mID;
+    }
+
+    /* Private Methods ****************************************************************************/
+
+    void Scheduler::UpdateNextTime ()
+    {
+        mNextTime = (mEvents.empty() == true) ? NEVER : mEvents.front().mTime;
+    }
+
+}
@@ -0,0 +1,67 @@
+/// @file TMM.Cache.hpp
+
+#pragma once
+
+#include <TMM.Common.hpp>
+
+namespace tmm
+{
+
+    class Cache
+    {
+    public:
+        struct Artifact
+        {
+            tmc::String     mName   = "";   // Name of the artifact within a cache entry.
+            tmc::Path       mPath   = "";   // Where the artifact is written by the build.
+        };
+
+    public:
+        Cache (const tmc::Path& pDirectory);
+
+    public:
+        tmc::Boolean        Lookup (const tmc::Path& pInput, const tmc::String& pOptions,
+                                const tmc::List<Artifact>& pArtifacts) const;
+        tmc::Boolean        Store (const tmc::Path& pInput, const tmc::String& pOptions,
+                                const tmc::Set<tmc::Path>& pDependencies,
+                                const tmc::List<Artifact>& pArtifacts) const;
+
+    public:
+        static tmc::Uint64  HashBytes (const void* pData, const tmc::Index& pSize,
+                                const tmc::Uint64& pSeed = 0);
+        static tmc::Boolean HashFile (const tmc::Path& pPath, tmc::Uint64& pHash);
+
+    private:
+        struct HashStamp
+        {
+            tmc::Uint64     mDevice     = 0;
+            tmc::Uint64     mInode      = 0;
+            tmc::Uint64     mSize       = 0;
+            tmc::Uint64     mModified   = 0;
+            tmc::Uint64     mChanged    = 0;
+            tmc::Uint64     mHash       = 0;
+
+        public:
+            inline tmc::Boolean IsSameFile (const HashStamp& pOther) const
+            {
+                return  mDevice == pOther.mDevice && mInode == pOther.mInode && mSize == pOther.mSize &&
+                        mModified == pOther.mModified && mChanged == pOther.mChanged;
+            }
+        };
+
+    private:
+        tmc::Path           GetManifestPath (const tmc::Path& pInput, const tmc::String& pOptions) const;
+        tmc::Path           GetEntryPath (const tmc::String& pDependencies,
+                                const tmc::String& pOptions) const;
+        tmc::Path           MakeTemporaryPath () const;
+
+    private:
+        tmc::Path           mDirectory;
+
+    private:
+        static std::mutex                   sHashMutex;
+        static tmc::Dictionary<HashStamp>   sHashes;
+
+    };
+
+}
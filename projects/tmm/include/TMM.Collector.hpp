@@ -0,0 +1,42 @@
+/// @file TMM.Collector.hpp
+
+#pragma once
+
+#include <TMM.Object.hpp>
+
+namespace tmm
+{
+
+    class Collector
+    {
+    public:
+        Collector (Object& pObject);
+
+    public:
+        tmc::Index Run ();
+
+    private:
+        struct Chunk
+        {
+            Section*        mSection        = nullptr;
+            tmc::Index      mBegin          = 0;
+            tmc::Index      mEnd            = 0;
+            tmc::Boolean    mFallsThrough   = true;     // Control, or a table, may run on into the next chunk.
+            tmc::Boolean    mLive           = false;
+        };
+
+    private:
+        void        BuildChunks ();
+        void        MarkLive (const tmc::Index& pChunk);
+        void        MarkReferences (const Expression::Ptr& pExpression);
+        tmc::Index  Sweep ();
+
+    private:
+        Object&                         mObject;
+        tmc::List<Chunk>                mChunks;
+        tmc::Dictionary<tmc::Index>     mLabels;        // Label name to the chunk it begins.
+        tmc::List<tmc::Index>           mPending;
+
+    };
+
+}
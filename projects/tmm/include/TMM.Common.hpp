@@ -7,6 +7,17 @@
 namespace tmm
 {
 
+    // Bump whenever the emitted output changes for the same input; cached builds are keyed on it.
+    constexpr const tmc::Char*  ASSEMBLER_VERSION       = "0.1.0";
 
+    inline tmc::Boolean IsInRange (const tmc::Int64& pValue, const tmc::Index& pSize,
+        const tmc::Boolean& pSigned)
+    {
+        const tmc::Int64 lBits = static_cast<tmc::Int64>(pSize * 8);
+        const tmc::Int64 lMinimum = -(1LL << (lBits - 1));
+        const tmc::Int64 lMaximum = (pSigned == true) ? (1LL << (lBits - 1)) - 1 : (1LL << lBits) - 1;
+
+        return pValue >= lMinimum && pValue <= lMaximum;
+    }
 
 }
@@ -18,9 +18,15 @@ namespace tmm
         Environment ();
         Environment (Environment& pParent, const EnvironmentScope& pScope);
 
+    public:
+        tmc::Boolean        Define (const tmc::String& pSymbol, const RuntimeValue::Ptr& pValue);
+        RuntimeValue::Ptr   Resolve (const tmc::String& pSymbol) const;
+        void                Clear ();
+
     private:
-        Environment&        mParent;
-        EnvironmentScope    mScope = EnvironmentScope::Parent;
+        Environment&                        mParent;
+        EnvironmentScope                    mScope = EnvironmentScope::Parent;
+        tmc::Dictionary<RuntimeValue::Ptr>  mSymbols;
 
     };
 
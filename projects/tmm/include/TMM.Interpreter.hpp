@@ -5,6 +5,7 @@
 #include <TMM.Lexer.hpp>
 #include <TMM.Parser.hpp>
 #include <TMM.Object.hpp>
+#include <TMM.Macro.hpp>
 #include <TMM.Environment.hpp>
 
 namespace tmm
@@ -16,16 +17,91 @@ namespace tmm
         Interpreter (Lexer& pLexer, Parser& pParser, Object& pObject);
 
     public:
+        void         SetJobs (const tmc::Index& pJobs);
         tmc::Boolean Run (const Program::Ptr& pProgram);
+        tmc::Boolean RunStreaming ();
+        tmc::Boolean Link ();
+
+    public:
+        inline const tmc::Dictionary<tmc::MappedFile::Ptr>& GetBinaries () const { return mBinaries; }
+        inline tmc::Index GetFixupCount () const { return mFixupCount; }
+
+    private:
+        enum class OperandKind
+        {
+            None,
+            Register,       // X
+            Condition,      // N, CS, CC, ZS, ZC, OS, US
+            Indirect,       // [X]
+            Memory,         // [I]
+            Immediate       // I
+        };
+
+        struct Operand
+        {
+            OperandKind     mKind       = OperandKind::None;
+            tmc::Int32      mId         = 0;
+            Expression::Ptr mExpression = nullptr;
+        };
+
+        struct FixupRun
+        {
+            Section*        mSection    = nullptr;
+            tmc::Index      mBegin      = 0;        // First fragment in the run.
+            tmc::Index      mEnd        = 0;        // One past the last fragment in the run.
+        };
 
     private:
         RuntimeValue::Ptr Evaluate (const Statement::Ptr& pStatement);
+        RuntimeValue::Ptr EvaluateBody (const Statement::Body& pBody);
+        RuntimeValue::Ptr EvaluateStatement (const Statement::Ptr& pStatement);
+        RuntimeValue::Ptr EvaluateProgram (const Program::Ptr& pProgram);
+        RuntimeValue::Ptr EvaluateSection (const SectionStatement::Ptr& pStatement);
+        RuntimeValue::Ptr EvaluateLabel (const LabelStatement::Ptr& pStatement);
+        RuntimeValue::Ptr EvaluateData (const DataStatement::Ptr& pStatement);
+        RuntimeValue::Ptr EvaluateIncbin (const IncbinStatement::Ptr& pStatement);
+        RuntimeValue::Ptr EvaluateInstruction (const InstructionStatement::Ptr& pStatement);
+        RuntimeValue::Ptr EvaluateMacro (const MacroStatement::Ptr& pStatement);
+        RuntimeValue::Ptr EvaluateMacroCall (const MacroCallStatement::Ptr& pStatement);
+
+    private:
+        RuntimeValue::Ptr EvaluateBinary (const BinaryExpression::Ptr& pExpression);
+        RuntimeValue::Ptr EvaluateUnary (const UnaryExpression::Ptr& pExpression);
+        RuntimeValue::Ptr EvaluateIdentifier (const Identifier::Ptr& pExpression);
+
+    private:
+        tmc::Boolean    IsConstant (const Expression::Ptr& pExpression) const;
+        tmc::Boolean    EvaluateInteger (const Expression::Ptr& pExpression, tmc::Int64& pValue);
+        Operand         ClassifyOperand (const Expression::Ptr& pExpression) const;
+        Fragment&       PushFragment (const FragmentType& pType);
+        tmc::Boolean    EmitValue (Fragment& pFragment, const tmc::Index& pOffset, const tmc::Index& pSize,
+                            const Expression::Ptr& pExpression, const tmc::Boolean& pRelative = false);
+        tmc::Boolean    EmitCode (const tmc::Uint8& pInstruction, const tmc::Uint8& pX,
+                            const tmc::Uint8& pY, const Expression::Ptr& pImmediate = nullptr,
+                            const tmc::Index& pImmediateSize = 0, const tmc::Boolean& pRelative = false);
+        tmc::Boolean    EmitALU (const tmc::Uint8& pBase, const Operand& pFirst, const Operand& pSecond);
+        tmc::Boolean    EmitShift (const tmc::Uint8& pBase, const Operand& pFirst);
+        tmc::Boolean    EmitBitCheck (const tmc::Uint8& pBase, const Operand& pFirst, const Operand& pSecond);
+        tmc::Boolean    ResolveFixups (const FixupRun& pRun);
+        tmc::Boolean    ResolveFixup (Fragment& pFragment, const Fixup& pFixup);
 
     private:
         Lexer&      mLexer;
         Parser&     mParser;
         Object&     mObject;
         Environment mEnvironment;
+        Section*    mSection = nullptr;
+        tmc::Index  mFile = tmc::NPOS;
+        tmc::Index  mSyntaxFile = tmc::NPOS;    // The statement's file index, 'mFile' is in the object.
+        tmc::Index  mLine = 0;
+        tmc::Index  mJobs = 1;          // Threads used to patch fixups while linking.
+        tmc::Index  mFixupCount = 0;    // Fixups patched while linking.
+
+        tmc::Dictionary<Macro>  mMacros;
+        tmc::Index              mExpansionCount = 0;
+        tmc::Index              mExpansionDepth = 0;
+
+        tmc::Dictionary<tmc::MappedFile::Ptr>   mBinaries;
 
     };
 
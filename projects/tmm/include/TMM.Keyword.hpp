@@ -24,6 +24,10 @@ namespace tmm
         LT_DW,          // Data statement - "Data Word"
         LT_DL,          // Data statement - "Data Long"
         LT_DS,          // Data statement - "Data Spacing"
+        LT_MACRO,       // Macro definition
+        LT_ENDM,        // End of macro definition
+        LT_INCLUDE,     // Source file inclusion
+        LT_INCBIN,      // Binary file inclusion
 
     };
 
@@ -164,6 +168,7 @@ namespace tmm
 
     public:
         static const Keyword& Lookup (const tmc::String& pKeyword);
+        static const Keyword& LookupDirective (const tmc::String& pKeyword);
 
     };
 
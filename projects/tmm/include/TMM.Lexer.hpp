@@ -14,16 +14,50 @@ namespace tmm
         ~Lexer ();
 
     public:
+        void                Reset ();
         void                ListTokens () const;
-        tmc::Boolean        HasMoreTokens () const;
-        const Token&        TokenAt (const tmc::Index& pIndex = 0) const;
+        tmc::Boolean        HasMoreTokens ();
+        const Token&        TokenAt (const tmc::Index& pIndex = 0);
         Token               DiscardToken ();
         tmc::Boolean        DiscardTokenIf (const TokenType& pType);
+        void                ReleaseTokens ();
         tmc::Boolean        TokenizeFile (const tmc::Path& pPath);
         tmc::Boolean        TokenizeStream (std::istream& pStream);
+        tmc::Boolean        OpenFile (const tmc::Path& pPath);
+
+    public:
+        inline const tmc::Set<tmc::Path>& GetLexedPaths () const { return mLexedPaths; }
+        inline tmc::Index   GetTokenCount () const { return mTokens.size(); }
+        inline tmc::Boolean IsGood () const { return mFailed == false; }
+
+    public:
+        static void         SetModuleCaching (const tmc::Boolean& pEnabled);
+
+    private:
+        using Module = tmc::Shared<const tmc::List<Token>>;
+
+        struct Entry
+        {
+            fs::file_time_type  mModified;
+            tmc::Uint64         mSize       = 0;
+            Module              mModule     = nullptr;
+        };
+
+        struct Source
+        {
+            tmc::Unique<std::fstream>   mStream = nullptr;
+            tmc::Path                   mPath   = "";
+            tmc::Index                  mLine   = 1;
+        };
+
+    private:
+        Module              LoadModule (const tmc::Path& pPath);
+        tmc::Boolean        OpenSource (const tmc::Path& pPath);
+        tmc::Boolean        Fill (const tmc::Index& pIndex);
 
     private:
         tmc::Boolean        InsertToken (const TokenType& pType, const tmc::String& pValue = "");
+        tmc::Boolean        TokenizeNext (std::istream& pStream, tmc::Boolean& pEnd);
         tmc::Boolean        TokenizeIdentifier (std::istream& pStream, tmc::Int32& pCharacter);
         tmc::Boolean        TokenizeChar (std::istream& pStream, tmc::Int32& pCharacter);
         tmc::Boolean        TokenizeString (std::istream& pStream, tmc::Int32& pCharacter);
@@ -34,11 +68,20 @@ namespace tmm
         tmc::Boolean        TokenizeSymbol (std::istream& pStream, tmc::Int32& pCharacter);
     
     private:
-        tmc::List<Token>    mTokens;
+        std::deque<Token>   mTokens;        // A deque, so tokens stay put while more are streamed in.
         tmc::Index          mTokenPointer = 0;
+        tmc::Index          mReadPointer = 0;
         tmc::Path           mCurrentFile = "";
         tmc::Index          mCurrentLine = 0;
         tmc::Set<tmc::Path> mLexedPaths;
+        tmc::Index          mIncludeDepth = 0;
+        tmc::List<Source>   mSources;       // Files being streamed, innermost include last.
+        tmc::Boolean        mFailed = false;
+
+    private:
+        static tmc::Boolean                 sModuleCaching;
+        static std::mutex                   sModuleMutex;
+        static tmc::Dictionary<Entry>       sModules;
 
     };
 
@@ -0,0 +1,41 @@
+/// @file TMM.Macro.hpp
+
+#pragma once
+
+#include <TMM.Syntax.hpp>
+
+namespace tmm
+{
+
+    class Macro
+    {
+    public:
+        Macro (const MacroStatement::Ptr& pStatement);
+
+    public:
+        tmc::Boolean Expand (const Expression::Body& pArguments, const tmc::Index& pExpansion,
+            Statement::Body& pBody) const;
+
+    public:
+        inline const tmc::String& GetName () const { return mStatement->GetName(); }
+
+    private:
+        struct Context
+        {
+            const Expression::Body& mArguments;
+            const tmc::String       mSuffix;
+        };
+
+    private:
+        tmc::Boolean    IsInvariant (const Statement::Ptr& pStatement) const;
+        Statement::Ptr  Instantiate (const Statement::Ptr& pStatement, const Context& pContext) const;
+        Expression::Ptr Instantiate (const Expression::Ptr& pExpression, const Context& pContext) const;
+
+    private:
+        MacroStatement::Ptr     mStatement = nullptr;
+        tmc::Set<tmc::String>   mLocalLabels;
+        tmc::List<tmc::Boolean> mInvariant;
+
+    };
+
+}
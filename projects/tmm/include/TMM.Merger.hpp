@@ -0,0 +1,40 @@
+/// @file TMM.Merger.hpp
+
+#pragma once
+
+#include <TMM.Object.hpp>
+
+namespace tmm
+{
+
+    class Merger
+    {
+    public:
+        Merger (Object& pObject);
+
+    public:
+        tmc::Index Run ();
+
+    private:
+        struct Item
+        {
+            Section*        mSection    = nullptr;
+            tmc::Index      mFragment   = 0;        // The data fragment itself.
+            tmc::Index      mLabels     = 0;        // First of the labels naming it.
+            tmc::Boolean    mMergeable  = false;    // Named by labels alone, and so may be moved.
+            tmc::Index      mHost       = tmc::NPOS;
+            tmc::Index      mOffset     = 0;        // Offset of the item's bytes within its host.
+        };
+
+    private:
+        void        CollectItems ();
+        void        PlanMerges ();
+        tmc::Index  Rebuild ();
+
+    private:
+        Object&             mObject;
+        tmc::List<Item>     mItems;
+
+    };
+
+}
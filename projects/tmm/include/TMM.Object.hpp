@@ -2,13 +2,96 @@
 
 #pragma once
 
-#include <TMM.Common.hpp>
+#include <TMM.Syntax.hpp>
+#include <TMC.MappedFile.hpp>
 
 namespace tmm
 {
 
+    /* Fragment Type Enumeration ******************************************************************/
+
+    enum class FragmentType
+    {
+        Label,          // Zero-sized marker naming the address of the following fragment.
+        Code,           // A single encoded instruction.
+        Data,           // Bytes emitted by a 'DB', 'DW' or 'DL' statement.
+        Space,          // A zero-filled region reserved by a 'DS' statement.
+        Binary          // A slice of a file included by an 'INCBIN' statement, used in place.
+    };
+
+    /* Fixup Structure ****************************************************************************/
+
+    struct Fixup
+    {
+        Expression::Ptr mExpression = nullptr;
+        tmc::Index      mOffset     = 0;        // Offset of the patched value within the fragment.
+        tmc::Index      mSize       = 0;        // Size of the patched value, in bytes.
+        tmc::Boolean    mRelative   = false;    // Value is relative to the end of the fragment.
+    };
+
+    /* Fragment Structure *************************************************************************/
+
+    struct Fragment
+    {
+        FragmentType            mType           = FragmentType::Code;
+        tmc::String             mLabel          = "";
+        tmc::ByteBuffer         mBytes;
+        tmc::Index              mSpace          = 0;            // Size of a 'Space' or 'Binary' fragment.
+        tmc::MappedFile::Ptr    mBinary         = nullptr;
+        tmc::Index              mBinaryOffset   = 0;            // Offset of a 'Binary' fragment's slice.
+        tmc::List<Fixup>        mFixups;
+        tmc::Address            mAddress        = 0;
+        tmc::Index              mFile           = tmc::NPOS;    // Index into the object's file table.
+        tmc::Index              mLine           = 0;
+
+    public:
+        tmc::Word               GetOpcode () const;
+        tmc::Index              GetSize () const;
+        const tmc::Byte*        GetData () const;
+        void                    Patch (const tmc::Index& pOffset, const tmc::Index& pSize,
+                                    const tmc::Int64& pValue);
+
+    };
+
+    /* Section Structure **************************************************************************/
+
+    struct Section
+    {
+        tmc::Int32              mType       = 0;
+        tmc::Address            mStart      = 0;
+        tmc::Address            mEnd        = 0;
+        tmc::Index              mSize       = 0;
+        tmc::Boolean            mFloating   = false;    // Placed anywhere in its region.
+        tmc::List<Fragment>     mFragments;
+
+    public:
+        tmc::Boolean            IsEmpty () const;
+        tmc::Boolean            IsRAM () const;
+        tmc::String             GetName () const;
+
+    };
+
+    /* Object Class *******************************************************************************/
+
     class Object
     {
+    public:
+        Object ();
+
+    public:
+        Section&            GetSection (const tmc::Int32& pSectionType);
+        const Section&      GetSection (const tmc::Int32& pSectionType) const;
+        tmc::Index          InternFile (const tmc::Path& pPath);
+        tmc::Boolean        Layout ();
+        tmc::Index          GetSize () const;
+
+    public:
+        inline const tmc::List<tmc::Path>& GetFiles () const { return mFiles; }
+
+    private:
+        tmc::Array<Section, SectionType::ST_COUNT>  mSections;
+        tmc::List<tmc::Path>                        mFiles;
+        tmc::Dictionary<tmc::Index>                 mFileIndices;
 
     };
 
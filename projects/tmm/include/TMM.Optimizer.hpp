@@ -0,0 +1,42 @@
+/// @file TMM.Optimizer.hpp
+
+#pragma once
+
+#include <TMM.Object.hpp>
+
+namespace tmm
+{
+
+    class Optimizer
+    {
+    public:
+        Optimizer (Object& pObject);
+
+    public:
+        tmc::Index Run ();
+
+    private:
+        struct Block
+        {
+            tmc::Index              mBegin      = 0;
+            tmc::Index              mEnd        = 0;
+            tmc::List<tmc::Index>   mSuccessors = {};
+            tmc::Uint8              mExitLive   = 0;    // Flags read by unknown successors.
+            tmc::Uint8              mLiveIn     = 0;
+            tmc::Uint8              mLiveOut    = 0;
+        };
+
+    private:
+        tmc::Index OptimizeSection (Section& pSection);
+        tmc::Index RewritePairs (Section& pSection);
+        tmc::Index RewriteDeadFlags (Section& pSection);
+        void       BuildBlocks (const Section& pSection);
+        void       SolveLiveness (const Section& pSection);
+
+    private:
+        Object&             mObject;
+        tmc::List<Block>    mBlocks;
+
+    };
+
+}
@@ -11,6 +11,11 @@ namespace tmm
     {
     public:
         Program::Ptr    ParseProgram (Lexer& pLexer);
+        Statement::Ptr  ParseNextStatement (Lexer& pLexer);
+        void            Reset ();
+
+    private:
+        tmc::Index      InternFile (const tmc::Path& pPath);
 
     private:
         Statement::Ptr  ParseStatement (Lexer& pLexer);
@@ -18,6 +23,11 @@ namespace tmm
         Statement::Ptr  ParseLabel (Lexer& pLexer);
         Statement::Ptr  ParseData (Lexer& pLexer);
         Statement::Ptr  ParseInstruction (Lexer& pLexer);
+        Statement::Ptr  ParseMacro (Lexer& pLexer);
+        Statement::Ptr  ParseMacroCall (Lexer& pLexer);
+        Statement::Ptr  ParseIncbin (Lexer& pLexer);
+        tmc::Boolean    PackDataLiteral (Lexer& pLexer, DataStatement& pStatement,
+                            const tmc::Index& pSize, tmc::Boolean& pPacked);
 
     private:
         Expression::Ptr ParseExpression (Lexer& pLexer);
@@ -31,6 +41,11 @@ namespace tmm
     private:
         Expression::Ptr ParsePrimaryExpression (Lexer& pLexer);
 
+    private:
+        tmc::Set<tmc::String>   mMacros;
+        tmc::Path               mFilePath   = "";       // Of the last statement parsed,
+        tmc::Index              mFileIndex  = tmc::NPOS;    // and its index in the shared table.
+
     };
 
 }
@@ -0,0 +1,49 @@
+/// @file TMM.Placement.hpp
+
+#pragma once
+
+#include <TMM.Common.hpp>
+
+namespace tmm
+{
+
+    class Placement
+    {
+    public:
+        struct Range
+        {
+            tmc::Uint64     mStart  = 0;
+            tmc::Uint64     mEnd    = 0;        // Inclusive.
+            tmc::String     mName   = "";
+        };
+
+    public:
+        Placement ();
+
+    public:
+        tmc::Boolean    Reserve (const tmc::Uint64& pStart, const tmc::Uint64& pSize,
+                            const tmc::String& pName);
+        tmc::Boolean    Place (const tmc::Uint64& pSize, const tmc::Uint64& pLow,
+                            const tmc::Uint64& pHigh, const tmc::String& pName, tmc::Uint64& pStart);
+        const Range*    FindOverlap (const tmc::Uint64& pStart, const tmc::Uint64& pEnd) const;
+
+    private:
+        using Bounds    = std::pair<tmc::Uint64, tmc::Uint64>;
+        using GapSizes  = std::set<std::pair<tmc::Uint64, tmc::Uint64>>;
+
+    private:
+        GapSizes&       GetRegionGaps (const tmc::Uint64& pLow, const tmc::Uint64& pHigh);
+        void            TakeGap (const tmc::Uint64& pStart, const tmc::Uint64& pEnd);
+        void            AddGap (const tmc::Uint64& pStart, const tmc::Uint64& pEnd);
+        void            IndexGap (const tmc::Uint64& pStart, const tmc::Uint64& pEnd,
+                            const tmc::Boolean& pFree);
+
+    private:
+        std::map<tmc::Uint64, Range>                        mRanges;        // Placed ranges, by start.
+        std::map<tmc::Uint64, tmc::Uint64>                  mGaps;          // Free ranges, start to end.
+        std::map<Bounds, GapSizes>                          mRegionGaps;    // Free ranges within each
+                                                                            // region, by size.
+
+    };
+
+}
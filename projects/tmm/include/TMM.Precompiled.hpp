@@ -4,6 +4,17 @@
 #define TMM_PRECOMPILED_HPP
 
 #include <cctype>
+#include <algorithm>
+#include <iomanip>
+#include <cstring>
+#include <bit>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <mutex>
+#include <map>
+#include <set>
 #include <TMC.Precompiled.hpp>
 
 #endif
@@ -11,7 +11,12 @@ namespace tmm
 
     enum class RuntimeValueType
     {
-        Void
+        Void,
+        Number,
+        String,
+        Register,
+        Condition,
+        Address
     };
 
     /* Runtime Value Base Class *******************************************************************/
@@ -64,4 +69,109 @@ namespace tmm
 
     };
 
+    /* Number Value Class *************************************************************************/
+
+    class NumberValue : public RuntimeValue
+    {
+    public:
+        using Ptr = tmc::Shared<NumberValue>;
+
+    public:
+        inline NumberValue (const tmc::Int64& pValue) :
+            RuntimeValue    { RuntimeValueType::Number },
+            mValue          { pValue }
+        {}
+
+    public:
+        inline const tmc::Int64& GetValue () const { return mValue; }
+
+    private:
+        tmc::Int64 mValue = 0;
+
+    };
+
+    /* String Value Class *************************************************************************/
+
+    class StringValue : public RuntimeValue
+    {
+    public:
+        using Ptr = tmc::Shared<StringValue>;
+
+    public:
+        inline StringValue (const tmc::String& pValue) :
+            RuntimeValue    { RuntimeValueType::String },
+            mValue          { pValue }
+        {}
+
+    public:
+        inline const tmc::String& GetValue () const { return mValue; }
+
+    private:
+        tmc::String mValue = "";
+
+    };
+
+    /* Register Value Class ***********************************************************************/
+
+    class RegisterValue : public RuntimeValue
+    {
+    public:
+        using Ptr = tmc::Shared<RegisterValue>;
+
+    public:
+        inline RegisterValue (const tmc::Int32& pRegisterType) :
+            RuntimeValue    { RuntimeValueType::Register },
+            mRegisterType   { pRegisterType }
+        {}
+
+    public:
+        inline const tmc::Int32& GetRegisterType () const { return mRegisterType; }
+
+    private:
+        tmc::Int32 mRegisterType = 0;
+
+    };
+
+    /* Condition Value Class **********************************************************************/
+
+    class ConditionValue : public RuntimeValue
+    {
+    public:
+        using Ptr = tmc::Shared<ConditionValue>;
+
+    public:
+        inline ConditionValue (const tmc::Int32& pConditionType) :
+            RuntimeValue    { RuntimeValueType::Condition },
+            mConditionType  { pConditionType }
+        {}
+
+    public:
+        inline const tmc::Int32& GetConditionType () const { return mConditionType; }
+
+    private:
+        tmc::Int32 mConditionType = 0;
+
+    };
+
+    /* Address Value Class ************************************************************************/
+
+    class AddressValue : public RuntimeValue
+    {
+    public:
+        using Ptr = tmc::Shared<AddressValue>;
+
+    public:
+        inline AddressValue (const RuntimeValue::Ptr& pInnerValue) :
+            RuntimeValue    { RuntimeValueType::Address },
+            mInnerValue     { pInnerValue }
+        {}
+
+    public:
+        inline const RuntimeValue::Ptr& GetInnerValue () const { return mInnerValue; }
+
+    private:
+        RuntimeValue::Ptr mInnerValue = nullptr;
+
+    };
+
 }
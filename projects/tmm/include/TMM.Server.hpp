@@ -0,0 +1,44 @@
+/// @file TMM.Server.hpp
+
+#pragma once
+
+#include <TMM.Common.hpp>
+
+namespace tmm
+{
+
+    // A resident assembler, listening on a Unix domain socket.
+    //
+    // A request is the client's working directory, followed by the command-line arguments, each
+    // terminated by a null character; an empty string ends the request. The response is the
+    // exit code as a little-endian long, followed by everything the request printed. Requests
+    // are served one at a time, each as if it were a fresh invocation of 'tmm', except that
+    // lexed files and file hashes stay cached in memory in between. A request whose only
+    // argument is '--stop' shuts the server down. A client which does not finish sending its
+    // request, or reading the response, within the time limit is dropped, so that it cannot
+    // hold up the requests queued behind it.
+    class Server
+    {
+    public:
+        using Handler = std::function<tmc::Int32 ()>;
+
+    public:
+        static constexpr tmc::Index MAX_REQUEST_SIZE    = 1024 * 1024;
+        static constexpr tmc::Int32 CLIENT_TIMEOUT_MS   = 5000;
+
+    public:
+        Server (const tmc::Path& pSocketPath, const Handler& pHandler);
+
+    public:
+        tmc::Boolean        Run ();
+
+    private:
+        tmc::Boolean        Serve (const tmc::Int32& pClient);
+
+    private:
+        tmc::Path           mSocketPath;
+        Handler             mHandler;
+
+    };
+
+}
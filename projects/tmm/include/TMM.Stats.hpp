@@ -0,0 +1,71 @@
+/// @file TMM.Stats.hpp
+
+#pragma once
+
+#include <TMM.Common.hpp>
+
+namespace tmm
+{
+
+    /* Stats Format Enumeration *******************************************************************/
+
+    enum class StatsFormat
+    {
+        None,
+        Text,
+        JSON
+    };
+
+    /* Stats Class ********************************************************************************/
+
+    class Stats
+    {
+    public:
+        struct Phase
+        {
+            tmc::String     mName           = "";
+            tmc::String     mUnit           = "";
+            tmc::Index      mCount          = 0;        // Number of items the phase produced.
+            tmc::Float64    mSeconds        = 0.0;
+            tmc::Uint64     mAllocations    = 0;
+            tmc::Uint64     mAllocatedBytes = 0;
+            tmc::Uint64     mPeakRSS        = 0;        // Of the whole process, in bytes.
+        };
+
+    public:
+        Stats (const tmc::String& pInput, const StatsFormat& pFormat);
+
+    public:
+        void                Begin ();
+        void                End (const tmc::String& pName, const tmc::Index& pCount,
+                                const tmc::String& pUnit);
+        void                Report () const;
+
+    public:
+        inline tmc::Boolean IsEnabled () const { return mFormat != StatsFormat::None; }
+
+    public:
+        static StatsFormat  ParseFormat (const tmc::String& pFormat);
+        static tmc::Uint64  GetAllocationCount ();
+        static tmc::Uint64  GetAllocatedBytes ();
+        static void         Charge (const tmc::Uint64& pAllocations, const tmc::Uint64& pBytes);
+        static tmc::Uint64  GetPeakRSS ();
+
+    private:
+        tmc::String         FormatText () const;
+        tmc::String         FormatJSON () const;
+
+    private:
+        tmc::String                             mInput;
+        StatsFormat                             mFormat;
+        tmc::List<Phase>                        mPhases;
+        std::chrono::steady_clock::time_point   mStart;
+        tmc::Uint64                             mStartAllocations   = 0;
+        tmc::Uint64                             mStartBytes         = 0;
+
+    private:
+        static std::mutex   sReportMutex;
+
+    };
+
+}
@@ -17,6 +17,9 @@ namespace tmm
         LabelStatement,
         DataStatement,
         InstructionStatement,
+        MacroStatement,
+        MacroCallStatement,
+        IncbinStatement,
 
         // Expressions
         BinaryExpression,
@@ -45,7 +48,9 @@ namespace tmm
 
         inline Statement (const SyntaxType& pType) :
             mType   { pType }
-        {}
+        {
+            ++sCreatedCount;
+        }
 
     public:
 
@@ -63,6 +68,37 @@ namespace tmm
             return std::static_pointer_cast<T>(pSyntaxPtr);
         }
 
+    public:
+
+        inline void SetLocation (const tmc::Index& pFile, const tmc::Index& pLine)
+        {
+            mFile = pFile;
+            mLine = pLine;
+        }
+
+        // Source files are named by their index into a table shared by every syntax tree, so
+        // that a node's location costs no allocation. Trees outlive the objects assembled from
+        // them, so the table lives as long as the process does.
+        inline static tmc::Index InternFile (const tmc::Path& pPath)
+        {
+            std::lock_guard lLock { sFileMutex };
+            auto [lIter, lInserted] = sFileIndices.try_emplace(pPath.string(), sFiles.size());
+            if (lInserted == true)
+            {
+                sFiles.push_back(pPath);
+            }
+
+            return lIter->second;
+        }
+
+        inline static const tmc::Path& GetFilePath (const tmc::Index& pFile)
+        {
+            static const tmc::Path sUnknown = "";
+
+            std::lock_guard lLock { sFileMutex };
+            return (pFile < sFiles.size()) ? sFiles[pFile] : sUnknown;
+        }
+
     public:
 
         inline const SyntaxType& GetType () const
@@ -70,8 +106,24 @@ namespace tmm
             return mType;
         }
 
+        inline const tmc::Index&    GetFile () const { return mFile; }
+        inline const tmc::Path&     GetFilePath () const { return GetFilePath(mFile); }
+        inline const tmc::Index&    GetLine () const { return mLine; }
+
+    public:
+        inline static tmc::Index    GetCreatedCount () { return sCreatedCount; }
+
     protected:
-        SyntaxType mType;
+        SyntaxType  mType;
+        tmc::Index  mFile = tmc::NPOS;      // Index into the shared file table.
+        tmc::Index  mLine = 0;
+
+    private:
+        inline static thread_local tmc::Index sCreatedCount = 0;    // Nodes made on this thread.
+
+        inline static std::mutex                        sFileMutex;
+        inline static std::deque<tmc::Path>             sFiles;     // A deque, so paths stay put.
+        inline static tmc::Map<tmc::String, tmc::Index> sFileIndices;
 
     };  
 
@@ -200,19 +252,32 @@ namespace tmm
 
     public:
 
+        // Elements known while parsing are packed straight into the statement's bytes. Each
+        // expression is emitted at the offset into those bytes where it was pushed.
+        inline void PushBytes (const void* pData, const tmc::Index& pSize)
+        {
+            const tmc::Byte* lData = static_cast<const tmc::Byte*>(pData);
+            mBytes.insert(mBytes.end(), lData, lData + pSize);
+        }
+
         inline void PushExpression (const Expression::Ptr& pExpression)
         {
             mExpressionBody.push_back(pExpression);
+            mOffsets.push_back(mBytes.size());
         }
 
     public:
 
         inline const tmc::Int32&            GetDataType () const { return mDataType; }
+        inline const tmc::ByteBuffer&       GetBytes () const { return mBytes; }
         inline const Expression::Body&      GetExpressionBody () const { return mExpressionBody; }
+        inline const tmc::List<tmc::Index>& GetOffsets () const { return mOffsets; }
 
     private:
-        tmc::Int32          mDataType;
-        Expression::Body    mExpressionBody;
+        tmc::Int32              mDataType;
+        tmc::ByteBuffer         mBytes;
+        Expression::Body        mExpressionBody;
+        tmc::List<tmc::Index>   mOffsets;
 
     };
 
@@ -247,6 +312,91 @@ namespace tmm
 
     };
 
+    class MacroStatement : public Statement
+    {
+    public:
+        using Ptr = tmc::Shared<MacroStatement>;
+
+    public:
+
+        inline MacroStatement (
+            const tmc::String& pName,
+            const Statement::Body& pBody
+        ) :
+            Statement       { SyntaxType::MacroStatement },
+            mName           { pName },
+            mBody           { pBody }
+        {}
+
+    public:
+
+        inline const tmc::String&       GetName () const { return mName; }
+        inline const Statement::Body&   GetBody () const { return mBody; }
+
+    private:
+        tmc::String         mName = "";
+        Statement::Body     mBody;
+
+    };
+
+    class MacroCallStatement : public Statement
+    {
+    public:
+        using Ptr = tmc::Shared<MacroCallStatement>;
+
+    public:
+
+        inline MacroCallStatement (
+            const tmc::String& pName,
+            const Expression::Body& pArguments
+        ) :
+            Statement       { SyntaxType::MacroCallStatement },
+            mName           { pName },
+            mArguments      { pArguments }
+        {}
+
+    public:
+
+        inline const tmc::String&       GetName () const { return mName; }
+        inline const Expression::Body&  GetArguments () const { return mArguments; }
+
+    private:
+        tmc::String         mName = "";
+        Expression::Body    mArguments;
+
+    };
+
+    class IncbinStatement : public Statement
+    {
+    public:
+        using Ptr = tmc::Shared<IncbinStatement>;
+
+    public:
+
+        inline IncbinStatement (
+            const tmc::String& pPath,
+            const Expression::Ptr& pOffsetExpression = nullptr,
+            const Expression::Ptr& pLengthExpression = nullptr
+        ) :
+            Statement           { SyntaxType::IncbinStatement },
+            mPath               { pPath },
+            mOffsetExpression   { pOffsetExpression },
+            mLengthExpression   { pLengthExpression }
+        {}
+
+    public:
+
+        inline const tmc::String&       GetPath () const { return mPath; }
+        inline const Expression::Ptr&   GetOffsetExpression () const { return mOffsetExpression; }
+        inline const Expression::Ptr&   GetLengthExpression () const { return mLengthExpression; }
+
+    private:
+        tmc::String         mPath = "";
+        Expression::Ptr     mOffsetExpression = nullptr;
+        Expression::Ptr     mLengthExpression = nullptr;
+
+    };
+
     /* Expression Syntax Classes ******************************************************************/
 
     class BinaryExpression : public Expression
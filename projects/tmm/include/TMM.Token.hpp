@@ -100,6 +100,7 @@ namespace tmm
     public:
         const char*     ToString () const;
         const Keyword&  GetKeyword () const;
+        const Keyword&  GetDirective () const;
         tmc::Boolean    IsOperator () const;
         tmc::Boolean    IsAssignmentOperator () const;
         tmc::Boolean    IsLogicalOperator () const;
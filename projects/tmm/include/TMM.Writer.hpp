@@ -0,0 +1,38 @@
+/// @file TMM.Writer.hpp
+
+#pragma once
+
+#include <TMM.Object.hpp>
+
+namespace tmm
+{
+
+    class Writer
+    {
+    public:
+        Writer (const Object& pObject);
+
+    public:
+        void            SetProgramName (const tmc::String& pName);
+        void            SetProgramAuthor (const tmc::String& pAuthor);
+        void            SetRequestedRAMSize (const tmc::Long& pSize);
+        tmc::Boolean    WriteROM (const tmc::Path& pPath) const;
+        tmc::Boolean    WriteMap (const tmc::Path& pPath) const;
+        tmc::Boolean    WriteLineTable (const tmc::Path& pPath) const;
+        tmc::Boolean    WriteCodeMap (const tmc::Path& pPath) const;
+
+    public:
+        tmc::Index      GetImageSize () const;
+
+    private:
+        tmc::ByteBuffer BuildMetadata () const;
+
+    private:
+        const Object&   mObject;
+        tmc::String     mName       = "";
+        tmc::String     mAuthor     = "";
+        tmc::Long       mRAMSize    = 0;
+
+    };
+
+}
@@ -0,0 +1,417 @@
+/// @file TMM.Cache.cpp
+
+#include <TMM.Precompiled.hpp>
+#include <TMM.Cache.hpp>
+
+#if defined(TM_LINUX)
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+namespace tmm
+{
+
+    /* Static Constants ***************************************************************************/
+
+    static constexpr const tmc::Char*   MANIFEST_HEADER = "TMM-CACHE";
+
+    // The hash is XXH64: four independent lanes over 32-byte stripes, which keeps the multipliers
+    // pipelined and lets the compiler vectorize the main loop.
+    static constexpr tmc::Uint64        PRIME_1         = 0x9E3779B185EBCA87ULL;
+    static constexpr tmc::Uint64        PRIME_2         = 0xC2B2AE3D27D4EB4FULL;
+    static constexpr tmc::Uint64        PRIME_3         = 0x165667B19E3779F9ULL;
+    static constexpr tmc::Uint64        PRIME_4         = 0x85EBCA77C2B2AE63ULL;
+    static constexpr tmc::Uint64        PRIME_5         = 0x27D4EB2F165667C5ULL;
+
+    /* Static Members *****************************************************************************/
+
+    std::mutex                          Cache::sHashMutex;
+    tmc::Dictionary<Cache::HashStamp>   Cache::sHashes;
+
+    /* Static Functions ***************************************************************************/
+
+    static inline tmc::Uint64 Read64 (const tmc::Byte* pData)
+    {
+        tmc::Uint64 lValue = 0;
+        std::memcpy(&lValue, pData, sizeof(lValue));
+        return lValue;
+    }
+
+    static inline tmc::Uint64 Read32 (const tmc::Byte* pData)
+    {
+        tmc::Uint32 lValue = 0;
+        std::memcpy(&lValue, pData, sizeof(lValue));
+        return lValue;
+    }
+
+    static inline tmc::Uint64 Round (tmc::Uint64 pAccumulator, const tmc::Uint64& pInput)
+    {
+        pAccumulator += pInput * PRIME_2;
+        return std::rotl(pAccumulator, 31) * PRIME_1;
+    }
+
+    static inline tmc::Uint64 MergeRound (tmc::Uint64 pAccumulator, const tmc::Uint64& pValue)
+    {
+        pAccumulator ^= Round(0, pValue);
+        return pAccumulator * PRIME_1 + PRIME_4;
+    }
+
+    static tmc::String ToHex (const tmc::Uint64& pValue)
+    {
+        static constexpr const tmc::Char* HEX_DIGITS = "0123456789abcdef";
+
+        tmc::String lString(16, '0');
+        for (tmc::Index lIndex = 0; lIndex < 16; ++lIndex)
+        {
+            lString[15 - lIndex] = HEX_DIGITS[(pValue >> (lIndex * 4)) & 0xF];
+        }
+
+        return lString;
+    }
+
+    static tmc::Boolean CopyFile (const tmc::Path& pFrom, const tmc::Path& pTo)
+    {
+    #if defined(TM_LINUX)
+        // ROM images are sparse, so only their data extents are copied; the holes stay holes.
+        tmc::Int32 lFrom = ::open(pFrom.c_str(), O_RDONLY);
+        if (lFrom < 0)
+        {
+            return false;
+        }
+
+        tmc::Int32 lTo = ::open(pTo.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        struct ::stat lStat {};
+        tmc::Boolean lGood = lTo >= 0 && ::fstat(lFrom, &lStat) == 0 && ::ftruncate(lTo, lStat.st_size) == 0;
+
+        ::off_t lOffset = 0;
+        while (lGood == true && lOffset < lStat.st_size)
+        {
+            ::off_t lData = ::lseek(lFrom, lOffset, SEEK_DATA);
+            if (lData < 0) { break; }
+
+            ::off_t lHole = ::lseek(lFrom, lData, SEEK_HOLE);
+            if (lHole < 0) { lHole = lStat.st_size; }
+
+            ::off_t lInput = lData, lOutput = lData;
+            while (lGood == true && lInput < lHole)
+            {
+                ::ssize_t lCopied = ::copy_file_range(lFrom, &lInput, lTo, &lOutput,
+                    static_cast<tmc::Index>(lHole - lInput), 0);
+                lGood = lCopied > 0;
+            }
+
+            lOffset = lHole;
+        }
+
+        if (lTo >= 0) { lGood = (::close(lTo) == 0) && lGood; }
+        ::close(lFrom);
+        return lGood;
+    #else
+        std::error_code lError;
+        fs::copy_file(pFrom, pTo, fs::copy_options::overwrite_existing, lError);
+        return !lError;
+    #endif
+    }
+
+    /* Public Constructors and Destructor *********************************************************/
+
+    Cache::Cache (const tmc::Path& pDirectory) :
+        mDirectory { pDirectory }
+    {
+
+    }
+
+    /* Public Methods *****************************************************************************/
+
+    tmc::Boolean Cache::Lookup (const tmc::Path& pInput, const tmc::String& pOptions,
+        const tmc::List<Artifact>& pArtifacts) const
+    {
+        tmc::File lManifest { GetManifestPath(pInput, pOptions), std::ios::in };
+        if (lManifest.is_open() == false)
+        {
+            return false;
+        }
+
+        tmc::String lLine = "";
+        if (std::getline(lManifest, lLine).good() == false ||
+            lLine != tmc::String { MANIFEST_HEADER } + " " + ASSEMBLER_VERSION)
+        {
+            return false;
+        }
+
+        // The manifest lists every file the last build of this input read, along with the hash
+        // it had then. The entry is only valid if none of them have changed since.
+        tmc::String lDependencies = "";
+        while (std::getline(lManifest, lLine).good() == true)
+        {
+            if (lLine.size() < 18 || lLine[16] != ' ')
+            {
+                return false;
+            }
+
+            tmc::Uint64 lHash = 0;
+            if (HashFile(lLine.substr(17), lHash) == false || ToHex(lHash) != lLine.substr(0, 16))
+            {
+                return false;
+            }
+
+            lDependencies += lLine + "\n";
+        }
+
+        const tmc::Path lEntry = GetEntryPath(lDependencies, pOptions);
+        for (const Artifact& lArtifact : pArtifacts)
+        {
+            if (fs::exists(lEntry / lArtifact.mName) == false)
+            {
+                return false;
+            }
+        }
+
+        for (const Artifact& lArtifact : pArtifacts)
+        {
+            if (CopyFile(lEntry / lArtifact.mName, lArtifact.mPath) == false)
+            {
+                std::cerr << "[Cache] Could not restore '" << lArtifact.mPath.string() << "'." << std::endl;
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    tmc::Boolean Cache::Store (const tmc::Path& pInput, const tmc::String& pOptions,
+        const tmc::Set<tmc::Path>& pDependencies, const tmc::List<Artifact>& pArtifacts) const
+    {
+        std::error_code lError;
+        fs::create_directories(mDirectory, lError);
+        if (lError)
+        {
+            std::cerr << "[Cache] Could not create cache directory '" << mDirectory.string() << "'." << std::endl;
+            return false;
+        }
+
+        tmc::List<tmc::Path> lPaths { pDependencies.begin(), pDependencies.end() };
+        std::sort(lPaths.begin(), lPaths.end());
+
+        tmc::String lDependencies = "";
+        for (const tmc::Path& lPath : lPaths)
+        {
+            tmc::Uint64 lHash = 0;
+            if (HashFile(lPath, lHash) == false)
+            {
+                return false;
+            }
+
+            lDependencies += ToHex(lHash) + " " + lPath.string() + "\n";
+        }
+
+        // Entries are immutable once published. Each is assembled in a private directory, then
+        // renamed into place; if another process got there first, its copy is just as good.
+        const tmc::Path lEntry = GetEntryPath(lDependencies, pOptions);
+        if (fs::exists(lEntry) == false)
+        {
+            const tmc::Path lTemporary = MakeTemporaryPath();
+            tmc::Boolean lGood = fs::create_directory(lTemporary, lError);
+
+            for (const Artifact& lArtifact : pArtifacts)
+            {
+                lGood = lGood && CopyFile(lArtifact.mPath, lTemporary / lArtifact.mName);
+            }
+
+            if (lGood == true)
+            {
+                fs::rename(lTemporary, lEntry, lError);
+            }
+
+            if (lGood == false || lError)
+            {
+                fs::remove_all(lTemporary, lError);
+                if (fs::exists(lEntry) == false)
+                {
+                    std::cerr << "[Cache] Could not store cache entry '" << lEntry.string() << "'." << std::endl;
+                    return false;
+                }
+            }
+        }
+
+        // The manifest is replaced atomically, so readers see either the old one or the new one.
+        const tmc::Path lManifestPath = GetManifestPath(pInput, pOptions);
+        const tmc::Path lTemporary = MakeTemporaryPath();
+        {
+            tmc::File lManifest { lTemporary, std::ios::out | std::ios::trunc };
+            lManifest << MANIFEST_HEADER << " " << ASSEMBLER_VERSION << "\n" << lDependencies;
+            lManifest.close();
+
+            if (lManifest.good() == true)
+            {
+                fs::rename(lTemporary, lManifestPath, lError);
+            }
+            else
+            {
+                lError = std::make_error_code(std::errc::io_error);
+            }
+        }
+
+        if (lError)
+        {
+            fs::remove(lTemporary, lError);
+            std::cerr << "[Cache] Could not write manifest '" << lManifestPath.string() << "'." << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    /* Public Static Methods **********************************************************************/
+
+    tmc::Uint64 Cache::HashBytes (const void* pData, const tmc::Index& pSize, const tmc::Uint64& pSeed)
+    {
+        const tmc::Byte* lData = static_cast<const tmc::Byte*>(pData);
+        const tmc::Byte* lEnd = lData + pSize;
+        tmc::Uint64 lHash = 0;
+
+        if (pSize >= 32)
+        {
+            tmc::Uint64 lLanes[4] = { pSeed + PRIME_1 + PRIME_2, pSeed + PRIME_2, pSeed, pSeed - PRIME_1 };
+            for (; lData + 32 <= lEnd; lData += 32)
+            {
+                for (tmc::Index lLane = 0; lLane < 4; ++lLane)
+                {
+                    lLanes[lLane] = Round(lLanes[lLane], Read64(lData + lLane * 8));
+                }
+            }
+
+            lHash = std::rotl(lLanes[0], 1) + std::rotl(lLanes[1], 7) + std::rotl(lLanes[2], 12) +
+                std::rotl(lLanes[3], 18);
+            for (tmc::Index lLane = 0; lLane < 4; ++lLane)
+            {
+                lHash = MergeRound(lHash, lLanes[lLane]);
+            }
+        }
+        else
+        {
+            lHash = pSeed + PRIME_5;
+        }
+
+        lHash += pSize;
+        for (; lData + 8 <= lEnd; lData += 8)
+        {
+            lHash = std::rotl(lHash ^ Round(0, Read64(lData)), 27) * PRIME_1 + PRIME_4;
+        }
+
+        if (lData + 4 <= lEnd)
+        {
+            lHash = std::rotl(lHash ^ (Read32(lData) * PRIME_1), 23) * PRIME_2 + PRIME_3;
+            lData += 4;
+        }
+
+        for (; lData < lEnd; ++lData)
+        {
+            lHash = std::rotl(lHash ^ (*lData * PRIME_5), 11) * PRIME_1;
+        }
+
+        lHash ^= lHash >> 33;
+        lHash *= PRIME_2;
+        lHash ^= lHash >> 29;
+        lHash *= PRIME_3;
+        lHash ^= lHash >> 32;
+        return lHash;
+    }
+
+    tmc::Boolean Cache::HashFile (const tmc::Path& pPath, tmc::Uint64& pHash)
+    {
+    #if defined(TM_LINUX)
+        tmc::Int32 lFile = ::open(pPath.c_str(), O_RDONLY);
+        struct ::stat lStat {};
+
+        if (lFile < 0 || ::fstat(lFile, &lStat) != 0)
+        {
+            if (lFile >= 0) { ::close(lFile); }
+            return false;
+        }
+
+        // A file whose identity, size and timestamps are unchanged is not hashed again. This
+        // matters to a resident assembler, which checks the same files request after request.
+        const HashStamp lStamp {
+            static_cast<tmc::Uint64>(lStat.st_dev), static_cast<tmc::Uint64>(lStat.st_ino),
+            static_cast<tmc::Uint64>(lStat.st_size),
+            static_cast<tmc::Uint64>(lStat.st_mtim.tv_sec) * 1000000000ULL + lStat.st_mtim.tv_nsec,
+            static_cast<tmc::Uint64>(lStat.st_ctim.tv_sec) * 1000000000ULL + lStat.st_ctim.tv_nsec, 0
+        };
+
+        {
+            std::lock_guard lLock { sHashMutex };
+
+            auto lIter = sHashes.find(pPath.string());
+            if (lIter != sHashes.end() && lIter->second.IsSameFile(lStamp) == true)
+            {
+                ::close(lFile);
+                pHash = lIter->second.mHash;
+                return true;
+            }
+        }
+
+        void* lMapping = (lStat.st_size > 0) ?
+            ::mmap(nullptr, static_cast<tmc::Index>(lStat.st_size), PROT_READ, MAP_PRIVATE, lFile, 0) : nullptr;
+        ::close(lFile);
+
+        if (lMapping == MAP_FAILED)
+        {
+            return false;
+        }
+
+        pHash = HashBytes(lMapping, static_cast<tmc::Index>(lStat.st_size));
+        if (lMapping != nullptr)
+        {
+            ::munmap(lMapping, static_cast<tmc::Index>(lStat.st_size));
+        }
+
+        std::lock_guard lLock { sHashMutex };
+        sHashes[pPath.string()] = lStamp;
+        sHashes[pPath.string()].mHash = pHash;
+        return true;
+    #else
+        tmc::File lFile { pPath, std::ios::in | std::ios::binary };
+        if (lFile.is_open() == false)
+        {
+            return false;
+        }
+
+        tmc::ByteBuffer lBuffer { std::istreambuf_iterator<tmc::Char>(lFile), std::istreambuf_iterator<tmc::Char>() };
+        pHash = HashBytes(lBuffer.data(), lBuffer.size());
+        return true;
+    #endif
+    }
+
+    /* Private Methods ****************************************************************************/
+
+    tmc::Path Cache::GetManifestPath (const tmc::Path& pInput, const tmc::String& pOptions) const
+    {
+        const tmc::String lKey = fs::absolute(pInput).lexically_normal().string() + '\0' + pOptions;
+        return mDirectory / (ToHex(HashBytes(lKey.data(), lKey.size())) + ".manifest");
+    }
+
+    tmc::Path Cache::GetEntryPath (const tmc::String& pDependencies, const tmc::String& pOptions) const
+    {
+        const tmc::String lKey = tmc::String { ASSEMBLER_VERSION } + '\0' + pOptions + '\0' + pDependencies;
+        return mDirectory / ToHex(HashBytes(lKey.data(), lKey.size()));
+    }
+
+    tmc::Path Cache::MakeTemporaryPath () const
+    {
+        // Unique across processes sharing the cache, and across threads within one.
+        static std::atomic<tmc::Uint64> sCounter { 0 };
+
+        const tmc::Uint64 lValues[] = {
+            std::random_device {}(),
+            sCounter.fetch_add(1),
+            static_cast<tmc::Uint64>(std::chrono::steady_clock::now().time_since_epoch().count()),
+            std::hash<std::thread::id> {}(std::this_thread::get_id())
+        };
+
+        return mDirectory / ("tmp-" + ToHex(HashBytes(lValues, sizeof(lValues))));
+    }
+
+}
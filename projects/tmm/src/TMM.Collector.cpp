@@ -0,0 +1,239 @@
+/// @file TMM.Collector.cpp
+
+#include <TMM.Precompiled.hpp>
+#include <TMM.Collector.hpp>
+
+namespace tmm
+{
+
+    /* Static Functions ***************************************************************************/
+
+    static tmc::Boolean IsData (const Fragment& pFragment)
+    {
+        return pFragment.mType != FragmentType::Label && pFragment.mType != FragmentType::Code;
+    }
+
+    static tmc::Boolean FallsThrough (const Fragment& pFragment)
+    {
+        // Control runs on past a label, and past any instruction but an unconditional transfer.
+        // It never runs into whatever follows data.
+        if (pFragment.mType == FragmentType::Label)
+        {
+            return true;
+        }
+        else if (pFragment.mType != FragmentType::Code)
+        {
+            return false;
+        }
+
+        const tmc::Word lOpcode = pFragment.GetOpcode();
+        switch (lOpcode >> 8)
+        {
+            case 0x20:  // JMP X, [A32]
+            case 0x21:  // JMP X, [Y]
+            case 0x22:  // JPB X, S16
+            case 0x25:  // RET X
+                return ((lOpcode >> 4) & 0xF) != ConditionType::CT_N;
+            case 0x26:  // RETI
+            case 0xFF:  // JPS
+                return false;
+            default:
+                return true;
+        }
+    }
+
+    /* Public Constructors and Destructor *********************************************************/
+
+    Collector::Collector (Object& pObject) :
+        mObject { pObject }
+    {
+
+    }
+
+    /* Public Methods *****************************************************************************/
+
+    tmc::Index Collector::Run ()
+    {
+        BuildChunks();
+
+        // The roots are the program's entry point at the start of the 'PROGRAM' section, every
+        // populated restart and interrupt vector, and all of the extra metadata.
+        for (tmc::Index lIndex = 0; lIndex < mChunks.size(); ++lIndex)
+        {
+            const Chunk& lChunk = mChunks[lIndex];
+            const tmc::Int32 lType = lChunk.mSection->mType;
+
+            if (lType == SectionType::ST_METADATA || lChunk.mBegin == 0)
+            {
+                MarkLive(lIndex);
+            }
+        }
+
+        // Everything reachable from a live chunk, by falling through or by naming one of its
+        // labels in a jump, call or data statement, is live too; so is the rest of a table.
+        while (mPending.empty() == false)
+        {
+            const tmc::Index lIndex = mPending.back();
+            mPending.pop_back();
+
+            const Chunk& lChunk = mChunks[lIndex];
+            for (tmc::Index lFragment = lChunk.mBegin; lFragment < lChunk.mEnd; ++lFragment)
+            {
+                for (const Fixup& lFixup : lChunk.mSection->mFragments[lFragment].mFixups)
+                {
+                    MarkReferences(lFixup.mExpression);
+                }
+            }
+
+            if (lChunk.mFallsThrough == true && lIndex + 1 < mChunks.size() &&
+                mChunks[lIndex + 1].mSection == lChunk.mSection)
+            {
+                MarkLive(lIndex + 1);
+            }
+        }
+
+        return Sweep();
+    }
+
+    /* Private Methods ****************************************************************************/
+
+    void Collector::BuildChunks ()
+    {
+        mChunks.clear();
+        mLabels.clear();
+        mPending.clear();
+
+        // A chunk runs from a label to the next one. RAM sections are never emitted, so they are
+        // left alone, and so are the labels in them.
+        for (tmc::Int32 lType = 0; lType < SectionType::ST_COUNT; ++lType)
+        {
+            Section& lSection = mObject.GetSection(lType);
+            if (lSection.IsRAM() == true || lSection.mFragments.empty() == true)
+            {
+                continue;
+            }
+
+            const auto& lFragments = lSection.mFragments;
+            for (tmc::Index lIndex = 0; lIndex < lFragments.size(); ++lIndex)
+            {
+                if (lIndex == 0 || lFragments[lIndex].mType == FragmentType::Label)
+                {
+                    if (mChunks.empty() == false && mChunks.back().mSection == &lSection)
+                    {
+                        mChunks.back().mEnd = lIndex;
+                    }
+
+                    mChunks.push_back({ &lSection, lIndex, lFragments.size() });
+                }
+
+                if (lFragments[lIndex].mType == FragmentType::Label)
+                {
+                    mLabels[lFragments[lIndex].mLabel] = mChunks.size() - 1;
+                }
+            }
+        }
+
+        // Data running straight on into more data is taken to be one table, which may be read
+        // past any label within it, so it is kept or dropped as a whole.
+        for (tmc::Index lIndex = 0; lIndex < mChunks.size(); ++lIndex)
+        {
+            Chunk& lChunk = mChunks[lIndex];
+            const auto& lFragments = lChunk.mSection->mFragments;
+            lChunk.mFallsThrough = FallsThrough(lFragments[lChunk.mEnd - 1]);
+
+            if (IsData(lFragments[lChunk.mEnd - 1]) == true && lIndex + 1 < mChunks.size() &&
+                mChunks[lIndex + 1].mSection == lChunk.mSection)
+            {
+                const Chunk& lNext = mChunks[lIndex + 1];
+                tmc::Index lFirst = lNext.mBegin;
+                while (lFirst + 1 < lNext.mEnd && lFragments[lFirst].mType == FragmentType::Label)
+                {
+                    ++lFirst;
+                }
+
+                lChunk.mFallsThrough = IsData(lFragments[lFirst]);
+            }
+        }
+    }
+
+    void Collector::MarkLive (const tmc::Index& pChunk)
+    {
+        if (mChunks[pChunk].mLive == false)
+        {
+            mChunks[pChunk].mLive = true;
+            mPending.push_back(pChunk);
+        }
+    }
+
+    void Collector::MarkReferences (const Expression::Ptr& pExpression)
+    {
+        // Every symbol in an expression is taken as a reference, whatever is done with its value.
+        switch (pExpression->GetType())
+        {
+            case SyntaxType::Identifier:
+            {
+                auto lIter = mLabels.find(Expression::Cast<Identifier>(pExpression)->GetSymbol());
+                if (lIter != mLabels.end())
+                {
+                    MarkLive(lIter->second);
+                }
+
+                break;
+            }
+            case SyntaxType::BinaryExpression:
+            {
+                auto lBinary = Expression::Cast<BinaryExpression>(pExpression);
+                MarkReferences(lBinary->GetLefthandExpression());
+                MarkReferences(lBinary->GetRighthandExpression());
+                break;
+            }
+            case SyntaxType::UnaryExpression:
+                MarkReferences(Expression::Cast<UnaryExpression>(pExpression)->GetRighthandExpression());
+                break;
+            case SyntaxType::AddressExpression:
+                MarkReferences(Expression::Cast<AddressExpression>(pExpression)->GetInnerExpression());
+                break;
+            default:
+                break;
+        }
+    }
+
+    tmc::Index Collector::Sweep ()
+    {
+        // Chunks are swept from each section in order, so the live fragments keep their order.
+        tmc::Index lRemoved = 0;
+        tmc::Index lChunk = 0;
+
+        while (lChunk < mChunks.size())
+        {
+            Section& lSection = *mChunks[lChunk].mSection;
+            auto& lFragments = lSection.mFragments;
+            tmc::Index lTarget = 0;
+
+            for (; lChunk < mChunks.size() && mChunks[lChunk].mSection == &lSection; ++lChunk)
+            {
+                const Chunk& lCurrent = mChunks[lChunk];
+                for (tmc::Index lIndex = lCurrent.mBegin; lIndex < lCurrent.mEnd; ++lIndex)
+                {
+                    if (lCurrent.mLive == false)
+                    {
+                        lRemoved += lFragments[lIndex].GetSize();
+                        continue;
+                    }
+
+                    if (lTarget != lIndex)
+                    {
+                        lFragments[lTarget] = std::move(lFragments[lIndex]);
+                    }
+
+                    ++lTarget;
+                }
+            }
+
+            lFragments.resize(lTarget);
+        }
+
+        return lRemoved;
+    }
+
+}
@@ -21,4 +21,38 @@ namespace tmm
 
     }
 
+    /* Public Methods *****************************************************************************/
+
+    tmc::Boolean Environment::Define (const tmc::String& pSymbol, const RuntimeValue::Ptr& pValue)
+    {
+        if (mSymbols.contains(pSymbol) == true)
+        {
+            std::cerr << "[Environment] Symbol '" << pSymbol << "' is already defined." << std::endl;
+            return false;
+        }
+
+        mSymbols.emplace(pSymbol, pValue);
+        return true;
+    }
+
+    RuntimeValue::Ptr Environment::Resolve (const tmc::String& pSymbol) const
+    {
+        auto lIter = mSymbols.find(pSymbol);
+        if (lIter != mSymbols.end())
+        {
+            return lIter->second;
+        }
+        else if (&mParent != this)
+        {
+            return mParent.Resolve(pSymbol);
+        }
+
+        return nullptr;
+    }
+
+    void Environment::Clear ()
+    {
+        mSymbols.clear();
+    }
+
 }
@@ -2,10 +2,29 @@
 
 #include <TMM.Precompiled.hpp>
 #include <TMM.Interpreter.hpp>
+#include <TMM.Stats.hpp>
 
 namespace tmm
 {
 
+    /* Static Constants ***************************************************************************/
+
+    static constexpr tmc::Index MAX_EXPANSION_DEPTH = 64;
+    static constexpr tmc::Index FIXUPS_PER_RUN      = 4096;     // Fixups patched per parallel job.
+
+    /* Static Functions ***************************************************************************/
+
+    static tmc::Index GetRegisterSize (const tmc::Int32& pRegisterType)
+    {
+        // Registers are enumerated in groups of four: 'X', 'XW', 'XH' and 'XL'.
+        switch (pRegisterType & 0b11)
+        {
+            case 0:     return 4;
+            case 1:     return 2;
+            default:    return 1;
+        }
+    }
+
     /* Public Constructors and Destructor *********************************************************/
 
     Interpreter::Interpreter (Lexer& pLexer, Parser& pParser, Object& pObject) :
@@ -18,6 +37,11 @@ namespace tmm
 
     /* Public Methods *****************************************************************************/
 
+    void Interpreter::SetJobs (const tmc::Index& pJobs)
+    {
+        mJobs = std::max<tmc::Index>(pJobs, 1);
+    }
+
     tmc::Boolean Interpreter::Run (const Program::Ptr& pProgram)
     {
         auto lResult = Evaluate(pProgram);
@@ -25,16 +49,1005 @@ namespace tmm
         return (lResult != nullptr);
     }
 
+    tmc::Boolean Interpreter::RunStreaming ()
+    {
+        // Each statement is evaluated as soon as it is parsed, and then dropped; only the
+        // expressions of unresolved values are kept, in their fragments' fixups, until 'Link'.
+        mParser.Reset();
+
+        while (mLexer.HasMoreTokens() == true)
+        {
+            Statement::Ptr lStatement = mParser.ParseNextStatement(mLexer);
+            if (lStatement == nullptr || EvaluateStatement(lStatement) == nullptr)
+            {
+                return false;
+            }
+        }
+
+        return mLexer.IsGood();
+    }
+
+    tmc::Boolean Interpreter::Link ()
+    {
+        // Assign an address to every fragment now that the instruction stream is final.
+        if (mObject.Layout() == false)
+        {
+            return false;
+        }
+
+        // Define every label at the address assigned to it.
+        for (tmc::Int32 lType = 0; lType < SectionType::ST_COUNT; ++lType)
+        {
+            for (const Fragment& lFragment : mObject.GetSection(lType).mFragments)
+            {
+                if (lFragment.mType != FragmentType::Label) { continue; }
+
+                auto lValue = RuntimeValue::Make<NumberValue>(lFragment.mAddress);
+                if (mEnvironment.Define(lFragment.mLabel, lValue) == false)
+                {
+                    return false;
+                }
+            }
+        }
+
+        // Patch every value which could not be resolved during evaluation. Every label is defined
+        // by now and the environment is only read from, so the sections are cut into runs of
+        // fragments holding about the same number of fixups, which are patched concurrently.
+        tmc::List<FixupRun> lRuns;
+        for (tmc::Int32 lType = 0; lType < SectionType::ST_COUNT; ++lType)
+        {
+            Section& lSection = mObject.GetSection(lType);
+            tmc::Index lBegin = 0;
+            tmc::Index lCount = 0;
+
+            for (tmc::Index lIndex = 0; lIndex < lSection.mFragments.size(); ++lIndex)
+            {
+                lCount += lSection.mFragments[lIndex].mFixups.size();
+                mFixupCount += lSection.mFragments[lIndex].mFixups.size();
+                if (lCount >= FIXUPS_PER_RUN)
+                {
+                    lRuns.push_back({ &lSection, lBegin, lIndex + 1 });
+                    lBegin = lIndex + 1;
+                    lCount = 0;
+                }
+            }
+
+            if (lCount > 0)
+            {
+                lRuns.push_back({ &lSection, lBegin, lSection.mFragments.size() });
+            }
+        }
+
+        const tmc::Index lJobs = std::min(mJobs, lRuns.size());
+        if (lJobs <= 1)
+        {
+            for (const FixupRun& lRun : lRuns)
+            {
+                if (ResolveFixups(lRun) == false)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        std::atomic<tmc::Index>     lNextRun { 0 };
+        std::atomic<tmc::Boolean>   lFailed { false };
+
+        auto lWorker = [&] ()
+        {
+            for (tmc::Index lIndex = lNextRun++; lIndex < lRuns.size() && lFailed == false; lIndex = lNextRun++)
+            {
+                if (ResolveFixups(lRuns[lIndex]) == false)
+                {
+                    lFailed = true;
+                }
+            }
+        };
+
+        // The allocation counters are per-thread, so each helper's counts are handed back to
+        // this thread once it is joined, and show up in this file's statistics.
+        std::atomic<tmc::Uint64>    lHelperAllocations { 0 };
+        std::atomic<tmc::Uint64>    lHelperBytes { 0 };
+
+        auto lHelper = [&] ()
+        {
+            const tmc::Uint64 lStartAllocations = Stats::GetAllocationCount();
+            const tmc::Uint64 lStartBytes       = Stats::GetAllocatedBytes();
+
+            lWorker();
+
+            lHelperAllocations  += Stats::GetAllocationCount() - lStartAllocations;
+            lHelperBytes        += Stats::GetAllocatedBytes() - lStartBytes;
+        };
+
+        tmc::List<std::thread> lThreads;
+        for (tmc::Index lThread = 1; lThread < lJobs; ++lThread)
+        {
+            lThreads.emplace_back(lHelper);
+        }
+
+        lWorker();
+        for (std::thread& lThread : lThreads)
+        {
+            lThread.join();
+        }
+
+        Stats::Charge(lHelperAllocations, lHelperBytes);
+        return lFailed == false;
+    }
+
     /* Private Methods - Statement Evaluation *****************************************************/
 
     RuntimeValue::Ptr Interpreter::Evaluate (const Statement::Ptr& pStatement)
     {
         switch (pStatement->GetType())
         {
+            case SyntaxType::Program:
+                return EvaluateProgram(Statement::Cast<Program>(pStatement));
+            case SyntaxType::SectionStatement:
+                return EvaluateSection(Statement::Cast<SectionStatement>(pStatement));
+            case SyntaxType::LabelStatement:
+                return EvaluateLabel(Statement::Cast<LabelStatement>(pStatement));
+            case SyntaxType::DataStatement:
+                return EvaluateData(Statement::Cast<DataStatement>(pStatement));
+            case SyntaxType::InstructionStatement:
+                return EvaluateInstruction(Statement::Cast<InstructionStatement>(pStatement));
+            case SyntaxType::MacroStatement:
+                return EvaluateMacro(Statement::Cast<MacroStatement>(pStatement));
+            case SyntaxType::MacroCallStatement:
+                return EvaluateMacroCall(Statement::Cast<MacroCallStatement>(pStatement));
+            case SyntaxType::IncbinStatement:
+                return EvaluateIncbin(Statement::Cast<IncbinStatement>(pStatement));
+            case SyntaxType::BinaryExpression:
+                return EvaluateBinary(Statement::Cast<BinaryExpression>(pStatement));
+            case SyntaxType::UnaryExpression:
+                return EvaluateUnary(Statement::Cast<UnaryExpression>(pStatement));
+            case SyntaxType::Identifier:
+                return EvaluateIdentifier(Statement::Cast<Identifier>(pStatement));
+            case SyntaxType::AddressExpression:
+            {
+                auto lInner = Evaluate(Statement::Cast<AddressExpression>(pStatement)->GetInnerExpression());
+                if (lInner == nullptr) { return nullptr; }
+
+                return RuntimeValue::Make<AddressValue>(lInner);
+            }
+            case SyntaxType::RegisterLiteral:
+                return RuntimeValue::Make<RegisterValue>(
+                    Statement::Cast<RegisterLiteral>(pStatement)->GetRegisterType());
+            case SyntaxType::ConditionLiteral:
+                return RuntimeValue::Make<ConditionValue>(
+                    Statement::Cast<ConditionLiteral>(pStatement)->GetConditionType());
+            case SyntaxType::StringLiteral:
+                return RuntimeValue::Make<StringValue>(
+                    Statement::Cast<StringLiteral>(pStatement)->GetValue());
+            case SyntaxType::NumericLiteral:
+                return RuntimeValue::Make<NumberValue>(static_cast<tmc::Int64>(
+                    Statement::Cast<NumericLiteral>(pStatement)->GetValue()));
+            case SyntaxType::PlaceholderLiteral:
+                std::cerr << "[Interpreter] Placeholder '@"
+                          << Statement::Cast<PlaceholderLiteral>(pStatement)->GetSlot()
+                          << "' used outside of a macro." << std::endl;
+                return nullptr;
             default:
                 std::cerr << "[Interpreter] Un-implemented syntax node encountered." << std::endl;
                 return nullptr;
         }
     }
 
+    RuntimeValue::Ptr Interpreter::EvaluateBody (const Statement::Body& pBody)
+    {
+        for (const auto& lStatement : pBody)
+        {
+            if (EvaluateStatement(lStatement) == nullptr)
+            {
+                return nullptr;
+            }
+        }
+
+        return RuntimeValue::Make<VoidValue>();
+    }
+
+    RuntimeValue::Ptr Interpreter::EvaluateStatement (const Statement::Ptr& pStatement)
+    {
+        // Fragments emitted by the statement are tagged with its location. Statements mostly
+        // follow others from the same file, so its index in the object is only looked up anew
+        // when the file changes.
+        if (pStatement->GetFile() != mSyntaxFile)
+        {
+            mSyntaxFile = pStatement->GetFile();
+            mFile = mObject.InternFile(pStatement->GetFilePath());
+        }
+
+        mLine = pStatement->GetLine();
+
+        auto lResult = Evaluate(pStatement);
+        if (lResult == nullptr)
+        {
+            std::cerr   << "[Interpreter]   In file '" << pStatement->GetFilePath().string() << ":"
+                        << pStatement->GetLine() << "'." << std::endl;
+        }
+
+        return lResult;
+    }
+
+    RuntimeValue::Ptr Interpreter::EvaluateProgram (const Program::Ptr& pProgram)
+    {
+        return EvaluateBody(pProgram->GetBody());
+    }
+
+    RuntimeValue::Ptr Interpreter::EvaluateSection (const SectionStatement::Ptr& pStatement)
+    {
+        mSection = &mObject.GetSection(pStatement->GetSectionType());
+        return RuntimeValue::Make<VoidValue>();
+    }
+
+    RuntimeValue::Ptr Interpreter::EvaluateLabel (const LabelStatement::Ptr& pStatement)
+    {
+        const auto& lExpression = pStatement->GetExpression();
+        if (lExpression->GetType() != SyntaxType::Identifier)
+        {
+            std::cerr << "[Interpreter] Expected an identifier in label statement." << std::endl;
+            return nullptr;
+        }
+        else if (mSection == nullptr)
+        {
+            std::cerr << "[Interpreter] Label statement found outside of a section." << std::endl;
+            return nullptr;
+        }
+
+        Fragment& lFragment = PushFragment(FragmentType::Label);
+        lFragment.mLabel    = Expression::Cast<Identifier>(lExpression)->GetSymbol();
+
+        return RuntimeValue::Make<VoidValue>();
+    }
+
+    RuntimeValue::Ptr Interpreter::EvaluateData (const DataStatement::Ptr& pStatement)
+    {
+        const auto& lBody = pStatement->GetExpressionBody();
+
+        if (mSection == nullptr)
+        {
+            std::cerr << "[Interpreter] Data statement found outside of a section." << std::endl;
+            return nullptr;
+        }
+
+        // 'DS' statements reserve a zero-filled region, and are the only data statements allowed
+        // in RAM sections.
+        if (pStatement->GetDataType() == LanguageType::LT_DS)
+        {
+            tmc::Int64 lCount = 0;
+            if (lBody.size() != 1 || IsConstant(lBody.front()) == false)
+            {
+                std::cerr << "[Interpreter] Expected a single constant size in 'DS' statement." << std::endl;
+                return nullptr;
+            }
+            else if (EvaluateInteger(lBody.front(), lCount) == false)
+            {
+                return nullptr;
+            }
+            else if (lCount < 0)
+            {
+                std::cerr << "[Interpreter] Negative size in 'DS' statement." << std::endl;
+                return nullptr;
+            }
+
+            Fragment& lFragment = PushFragment(FragmentType::Space);
+            lFragment.mSpace    = static_cast<tmc::Index>(lCount);
+
+            return RuntimeValue::Make<VoidValue>();
+        }
+        else if (mSection->IsRAM() == true)
+        {
+            std::cerr << "[Interpreter] Only 'DS' data statements are allowed in RAM sections." << std::endl;
+            return nullptr;
+        }
+
+        tmc::Index lSize = 1;
+        switch (pStatement->GetDataType())
+        {
+            case LanguageType::LT_DW:   lSize = 2; break;
+            case LanguageType::LT_DL:   lSize = 4; break;
+            default:                    break;
+        }
+
+        Fragment& lFragment = PushFragment(FragmentType::Data);
+
+        // Elements packed by the parser are copied in bulk; the remaining expressions are
+        // emitted between them, at the offsets where they appeared.
+        const auto& lBytes = pStatement->GetBytes();
+        const auto& lOffsets = pStatement->GetOffsets();
+        tmc::Index lCopied = 0;
+
+        lFragment.mBytes.reserve(lBytes.size() + lBody.size() * lSize);
+        for (tmc::Index lIndex = 0; lIndex < lBody.size(); ++lIndex)
+        {
+            const auto& lExpression = lBody[lIndex];
+
+            lFragment.mBytes.insert(lFragment.mBytes.end(), lBytes.begin() + lCopied, lBytes.begin() + lOffsets[lIndex]);
+            lCopied = lOffsets[lIndex];
+
+            // String values are emitted one character per element.
+            if (IsConstant(lExpression) == true)
+            {
+                auto lValue = Evaluate(lExpression);
+                if (lValue == nullptr) { return nullptr; }
+
+                if (lValue->GetValueType() == RuntimeValueType::String)
+                {
+                    const tmc::String& lString = RuntimeValue::Cast<StringValue>(lValue)->GetValue();
+                    if (lSize == 1)
+                    {
+                        lFragment.mBytes.insert(lFragment.mBytes.end(), lString.begin(), lString.end());
+                        continue;
+                    }
+
+                    for (const tmc::Char& lCharacter : lString)
+                    {
+                        lFragment.mBytes.resize(lFragment.mBytes.size() + lSize, 0);
+                        lFragment.Patch(lFragment.mBytes.size() - lSize, lSize,
+                            static_cast<tmc::Byte>(lCharacter));
+                    }
+
+                    continue;
+                }
+            }
+
+            tmc::Index lOffset = lFragment.mBytes.size();
+            lFragment.mBytes.resize(lOffset + lSize, 0);
+            if (EmitValue(lFragment, lOffset, lSize, lExpression) == false)
+            {
+                return nullptr;
+            }
+        }
+
+        lFragment.mBytes.insert(lFragment.mBytes.end(), lBytes.begin() + lCopied, lBytes.end());
+        return RuntimeValue::Make<VoidValue>();
+    }
+
+    RuntimeValue::Ptr Interpreter::EvaluateIncbin (const IncbinStatement::Ptr& pStatement)
+    {
+        if (mSection == nullptr)
+        {
+            std::cerr << "[Interpreter] 'INCBIN' statement found outside of a section." << std::endl;
+            return nullptr;
+        }
+        else if (mSection->IsRAM() == true)
+        {
+            std::cerr << "[Interpreter] Only 'DS' data statements are allowed in RAM sections." << std::endl;
+            return nullptr;
+        }
+
+        // The file is named relative to the source file including it, and is only mapped once,
+        // however many times it is included.
+        tmc::Path lPath = pStatement->GetPath();
+        if (mFile < mObject.GetFiles().size())
+        {
+            lPath = mObject.GetFiles()[mFile].parent_path() / lPath;
+        }
+
+        lPath = fs::absolute(lPath).lexically_normal();
+
+        tmc::MappedFile::Ptr& lBinary = mBinaries[lPath.string()];
+        if (lBinary == nullptr && (lBinary = tmc::MappedFile::Open(lPath)) == nullptr)
+        {
+            return nullptr;
+        }
+
+        tmc::Int64 lOffset = 0, lLength = static_cast<tmc::Int64>(lBinary->GetSize());
+        if (pStatement->GetOffsetExpression() != nullptr &&
+            EvaluateInteger(pStatement->GetOffsetExpression(), lOffset) == false)
+        {
+            return nullptr;
+        }
+
+        lLength -= std::max<tmc::Int64>(lOffset, 0);
+        if (pStatement->GetLengthExpression() != nullptr &&
+            EvaluateInteger(pStatement->GetLengthExpression(), lLength) == false)
+        {
+            return nullptr;
+        }
+
+        if (lOffset < 0 || lLength < 0 || static_cast<tmc::Index>(lOffset + lLength) > lBinary->GetSize())
+        {
+            std::cerr   << "[Interpreter] Slice of " << lLength << " byte(s) at offset " << lOffset
+                        << " is outside of '" << lPath.string() << "' (" << lBinary->GetSize()
+                        << " bytes)." << std::endl;
+            return nullptr;
+        }
+
+        Fragment& lFragment     = PushFragment(FragmentType::Binary);
+        lFragment.mBinary       = lBinary;
+        lFragment.mBinaryOffset = static_cast<tmc::Index>(lOffset);
+        lFragment.mSpace        = static_cast<tmc::Index>(lLength);
+
+        return RuntimeValue::Make<VoidValue>();
+    }
+
+    RuntimeValue::Ptr Interpreter::EvaluateInstruction (const InstructionStatement::Ptr& pStatement)
+    {
+        if (mSection == nullptr)
+        {
+            std::cerr << "[Interpreter] Instruction found outside of a section." << std::endl;
+            return nullptr;
+        }
+        else if (mSection->IsRAM() == true)
+        {
+            std::cerr << "[Interpreter] Instructions are not allowed in RAM sections." << std::endl;
+            return nullptr;
+        }
+
+        Operand lFirst  = ClassifyOperand(pStatement->GetFirstOperandExpression());
+        Operand lSecond = ClassifyOperand(pStatement->GetSecondOperandExpression());
+        tmc::Boolean lResult = false;
+
+        using K = OperandKind;
+        const auto lX = static_cast<tmc::Uint8>(lFirst.mId);
+        const auto lY = static_cast<tmc::Uint8>(lSecond.mId);
+
+        switch (pStatement->GetInstructionType())
+        {
+            case InstructionType::IT_NOP:   lResult = EmitCode(0x00, 0, 0); break;
+            case InstructionType::IT_STOP:  lResult = EmitCode(0x01, 0, 0); break;
+            case InstructionType::IT_HALT:  lResult = EmitCode(0x02, 0, 0); break;
+            case InstructionType::IT_SEC:
+            {
+                // The error code is stored in the lo byte of the opcode itself.
+                if (lFirst.mKind != K::Immediate) { break; }
+                if (EmitCode(0x03, 0, 0) == false) { return nullptr; }
+                lResult = EmitValue(mSection->mFragments.back(), 0, 1, lFirst.mExpression);
+            } break;
+            case InstructionType::IT_CEC:   lResult = EmitCode(0x04, 0, 0); break;
+            case InstructionType::IT_DI:    lResult = EmitCode(0x05, 0, 0); break;
+            case InstructionType::IT_EI:    lResult = EmitCode(0x06, 0, 0); break;
+            case InstructionType::IT_DAL:   lResult = EmitCode(0x07, 0x0, 0); break;
+            case InstructionType::IT_DAW:   lResult = EmitCode(0x07, 0x1, 0); break;
+            case InstructionType::IT_DAB:   lResult = EmitCode(0x07, 0x2, 0); break;
+            case InstructionType::IT_CPL:   lResult = EmitCode(0x08, 0x0, 0); break;
+            case InstructionType::IT_CPW:   lResult = EmitCode(0x08, 0x1, 0); break;
+            case InstructionType::IT_CPB:   lResult = EmitCode(0x08, 0x2, 0); break;
+            case InstructionType::IT_SCF:   lResult = EmitCode(0x09, 0, 0); break;
+            case InstructionType::IT_CCF:   lResult = EmitCode(0x0A, 0, 0); break;
+
+            case InstructionType::IT_LD:
+                if (lFirst.mKind != K::Register) { break; }
+                else if (lSecond.mKind == K::Immediate)
+                    { lResult = EmitCode(0x10, lX, 0, lSecond.mExpression, GetRegisterSize(lFirst.mId)); }
+                else if (lSecond.mKind == K::Memory)
+                    { lResult = EmitCode(0x11, lX, 0, lSecond.mExpression, 4); }
+                else if (lSecond.mKind == K::Indirect)
+                    { lResult = EmitCode(0x12, lX, lY); }
+                break;
+            case InstructionType::IT_LDQ:
+                if (lFirst.mKind == K::Register && lSecond.mKind == K::Memory)
+                    { lResult = EmitCode(0x13, lX, 0, lSecond.mExpression, 2); }
+                break;
+            case InstructionType::IT_LDH:
+                if (lFirst.mKind == K::Register && lSecond.mKind == K::Memory)
+                    { lResult = EmitCode(0x14, lX, 0, lSecond.mExpression, 1); }
+                break;
+            case InstructionType::IT_ST:
+                if (lSecond.mKind != K::Register) { break; }
+                else if (lFirst.mKind == K::Memory)
+                    { lResult = EmitCode(0x15, 0, lY, lFirst.mExpression, 4); }
+                else if (lFirst.mKind == K::Indirect)
+                    { lResult = EmitCode(0x16, lX, lY); }
+                break;
+            case InstructionType::IT_STQ:
+                if (lFirst.mKind == K::Memory && lSecond.mKind == K::Register)
+                    { lResult = EmitCode(0x17, 0, lY, lFirst.mExpression, 2); }
+                break;
+            case InstructionType::IT_STH:
+                if (lFirst.mKind == K::Memory && lSecond.mKind == K::Register)
+                    { lResult = EmitCode(0x18, 0, lY, lFirst.mExpression, 1); }
+                break;
+            case InstructionType::IT_MV:
+                if (lFirst.mKind == K::Register && lSecond.mKind == K::Register)
+                    { lResult = EmitCode(0x19, lX, lY); }
+                break;
+            case InstructionType::IT_PUSH:
+                if (lFirst.mKind == K::Register) { lResult = EmitCode(0x1A, 0, lX); }
+                break;
+            case InstructionType::IT_POP:
+                if (lFirst.mKind == K::Register) { lResult = EmitCode(0x1B, lX, 0); }
+                break;
+
+            case InstructionType::IT_JMP:
+                if (lFirst.mKind != K::Condition) { break; }
+                else if (lSecond.mKind == K::Memory || lSecond.mKind == K::Immediate)
+                    { lResult = EmitCode(0x20, lX, 0, lSecond.mExpression, 4); }
+                else if (lSecond.mKind == K::Indirect)
+                    { lResult = EmitCode(0x21, lX, lY); }
+                break;
+            case InstructionType::IT_JPB:
+                // The operand names the target; the signed offset is taken from the end of
+                // the instruction.
+                if (lFirst.mKind == K::Condition && lSecond.mKind == K::Immediate)
+                    { lResult = EmitCode(0x22, lX, 0, lSecond.mExpression, 2, true); }
+                break;
+            case InstructionType::IT_CALL:
+                if (lFirst.mKind == K::Condition &&
+                    (lSecond.mKind == K::Memory || lSecond.mKind == K::Immediate))
+                    { lResult = EmitCode(0x23, lX, 0, lSecond.mExpression, 4); }
+                break;
+            case InstructionType::IT_RST:
+            {
+                tmc::Int64 lVector = 0;
+                if (lFirst.mKind != K::Immediate || IsConstant(lFirst.mExpression) == false) { break; }
+                if (EvaluateInteger(lFirst.mExpression, lVector) == false) { return nullptr; }
+                if (lVector < 0x0 || lVector > 0xF)
+                {
+                    std::cerr << "[Interpreter] Restart vector " << lVector << " is out of range." << std::endl;
+                    return nullptr;
+                }
+
+                lResult = EmitCode(0x24, static_cast<tmc::Uint8>(lVector), 0);
+            } break;
+            case InstructionType::IT_RET:
+                if (lFirst.mKind == K::Condition) { lResult = EmitCode(0x25, lX, 0); }
+                break;
+            case InstructionType::IT_RETI:  lResult = EmitCode(0x26, 0, 0); break;
+            case InstructionType::IT_JPS:   lResult = EmitCode(0xFF, 0xF, 0xF); break;
+
+            case InstructionType::IT_INC:
+                if (lFirst.mKind == K::Register)        { lResult = EmitCode(0x30, lX, 0); }
+                else if (lFirst.mKind == K::Indirect)   { lResult = EmitCode(0x31, 0, lX); }
+                break;
+            case InstructionType::IT_DEC:
+                if (lFirst.mKind == K::Register)        { lResult = EmitCode(0x32, lX, 0); }
+                else if (lFirst.mKind == K::Indirect)   { lResult = EmitCode(0x33, 0, lX); }
+                break;
+            case InstructionType::IT_ADD:   lResult = EmitALU(0x34, lFirst, lSecond); break;
+            case InstructionType::IT_ADC:   lResult = EmitALU(0x37, lFirst, lSecond); break;
+            case InstructionType::IT_SUB:   lResult = EmitALU(0x3A, lFirst, lSecond); break;
+            case InstructionType::IT_SBC:   lResult = EmitALU(0x3D, lFirst, lSecond); break;
+            case InstructionType::IT_AND:   lResult = EmitALU(0x40, lFirst, lSecond); break;
+            case InstructionType::IT_OR:    lResult = EmitALU(0x43, lFirst, lSecond); break;
+            case InstructionType::IT_XOR:   lResult = EmitALU(0x46, lFirst, lSecond); break;
+            case InstructionType::IT_CMP:   lResult = EmitALU(0x49, lFirst, lSecond); break;
+
+            case InstructionType::IT_SLA:   lResult = EmitShift(0x50, lFirst); break;
+            case InstructionType::IT_SRA:   lResult = EmitShift(0x52, lFirst); break;
+            case InstructionType::IT_SRL:   lResult = EmitShift(0x54, lFirst); break;
+            case InstructionType::IT_RL:    lResult = EmitShift(0x56, lFirst); break;
+            case InstructionType::IT_RLC:   lResult = EmitShift(0x58, lFirst); break;
+            case InstructionType::IT_RR:    lResult = EmitShift(0x5A, lFirst); break;
+            case InstructionType::IT_RRC:   lResult = EmitShift(0x5C, lFirst); break;
+
+            case InstructionType::IT_BIT:   lResult = EmitBitCheck(0x60, lFirst, lSecond); break;
+            case InstructionType::IT_SET:   lResult = EmitBitCheck(0x62, lFirst, lSecond); break;
+            case InstructionType::IT_RES:   lResult = EmitBitCheck(0x64, lFirst, lSecond); break;
+            case InstructionType::IT_SWAP:  lResult = EmitShift(0x66, lFirst); break;
+
+            default:
+                std::cerr << "[Interpreter] Un-implemented instruction encountered." << std::endl;
+                return nullptr;
+        }
+
+        if (lResult == false)
+        {
+            std::cerr << "[Interpreter] Invalid operands in instruction statement." << std::endl;
+            return nullptr;
+        }
+
+        return RuntimeValue::Make<VoidValue>();
+    }
+
+    RuntimeValue::Ptr Interpreter::EvaluateMacro (const MacroStatement::Ptr& pStatement)
+    {
+        if (mMacros.contains(pStatement->GetName()) == true)
+        {
+            std::cerr << "[Interpreter] Macro '" << pStatement->GetName() << "' is already defined." << std::endl;
+            return nullptr;
+        }
+
+        mMacros.emplace(pStatement->GetName(), Macro { pStatement });
+        return RuntimeValue::Make<VoidValue>();
+    }
+
+    RuntimeValue::Ptr Interpreter::EvaluateMacroCall (const MacroCallStatement::Ptr& pStatement)
+    {
+        auto lIter = mMacros.find(pStatement->GetName());
+        if (lIter == mMacros.end())
+        {
+            std::cerr << "[Interpreter] Macro '" << pStatement->GetName() << "' is not defined." << std::endl;
+            return nullptr;
+        }
+        else if (mExpansionDepth >= MAX_EXPANSION_DEPTH)
+        {
+            std::cerr << "[Interpreter] Macro '" << pStatement->GetName() << "' exceeds the maximum "
+                      << "expansion depth of " << MAX_EXPANSION_DEPTH << "." << std::endl;
+            return nullptr;
+        }
+
+        Statement::Body lBody;
+        if (lIter->second.Expand(pStatement->GetArguments(), mExpansionCount++, lBody) == false)
+        {
+            return nullptr;
+        }
+
+        ++mExpansionDepth;
+        auto lResult = EvaluateBody(lBody);
+        --mExpansionDepth;
+
+        return lResult;
+    }
+
+    /* Private Methods - Expression Evaluation ****************************************************/
+
+    RuntimeValue::Ptr Interpreter::EvaluateBinary (const BinaryExpression::Ptr& pExpression)
+    {
+        auto lLefthand = Evaluate(pExpression->GetLefthandExpression());
+        if (lLefthand == nullptr) { return nullptr; }
+
+        auto lRighthand = Evaluate(pExpression->GetRighthandExpression());
+        if (lRighthand == nullptr) { return nullptr; }
+
+        const auto& lOperator = pExpression->GetOperatorToken();
+        const auto  lLeftType = lLefthand->GetValueType();
+        const auto  lRightType = lRighthand->GetValueType();
+
+        // Strings may be concatenated with each other and with numbers, and compared for equality.
+        if (lLeftType == RuntimeValueType::String || lRightType == RuntimeValueType::String ||
+            lOperator.mType == TokenType::Concat)
+        {
+            auto lToString = [] (const RuntimeValue::Ptr& pValue) -> tmc::String
+            {
+                switch (pValue->GetValueType())
+                {
+                    case RuntimeValueType::String:
+                        return RuntimeValue::Cast<StringValue>(pValue)->GetValue();
+                    case RuntimeValueType::Number:
+                        return std::to_string(RuntimeValue::Cast<NumberValue>(pValue)->GetValue());
+                    default:
+                        return "";
+                }
+            };
+
+            tmc::String lLeftString = lToString(lLefthand);
+            tmc::String lRightString = lToString(lRighthand);
+
+            switch (lOperator.mType)
+            {
+                case TokenType::Plus:
+                case TokenType::Concat:
+                    return RuntimeValue::Make<StringValue>(lLeftString + lRightString);
+                case TokenType::CompareEquals:
+                case TokenType::CompareStrictEquals:
+                    return RuntimeValue::Make<NumberValue>(lLeftType == lRightType && lLeftString == lRightString);
+                case TokenType::CompareNotEquals:
+                case TokenType::CompareStrictNotEquals:
+                    return RuntimeValue::Make<NumberValue>(lLeftType != lRightType || lLeftString != lRightString);
+                default:
+                    std::cerr << "[Interpreter] Invalid '" << lOperator.ToString()
+                              << "' operation on string value." << std::endl;
+                    return nullptr;
+            }
+        }
+
+        if (lLeftType != RuntimeValueType::Number || lRightType != RuntimeValueType::Number)
+        {
+            std::cerr << "[Interpreter] Expected numeric operands in '" << lOperator.ToString()
+                      << "' expression." << std::endl;
+            return nullptr;
+        }
+
+        const tmc::Int64 lLeft = RuntimeValue::Cast<NumberValue>(lLefthand)->GetValue();
+        const tmc::Int64 lRight = RuntimeValue::Cast<NumberValue>(lRighthand)->GetValue();
+
+        switch (lOperator.mType)
+        {
+            case TokenType::Plus:                   return RuntimeValue::Make<NumberValue>(lLeft + lRight);
+            case TokenType::Minus:                  return RuntimeValue::Make<NumberValue>(lLeft - lRight);
+            case TokenType::Times:                  return RuntimeValue::Make<NumberValue>(lLeft * lRight);
+            case TokenType::Divide:
+            case TokenType::Modulo:
+                if (lRight == 0)
+                {
+                    std::cerr << "[Interpreter] Division by zero." << std::endl;
+                    return nullptr;
+                }
+
+                return RuntimeValue::Make<NumberValue>(
+                    (lOperator.mType == TokenType::Divide) ? lLeft / lRight : lLeft % lRight);
+            case TokenType::BitwiseAnd:             return RuntimeValue::Make<NumberValue>(lLeft & lRight);
+            case TokenType::BitwiseOr:              return RuntimeValue::Make<NumberValue>(lLeft | lRight);
+            case TokenType::BitwiseXor:             return RuntimeValue::Make<NumberValue>(lLeft ^ lRight);
+            case TokenType::BitwiseLeftShift:       return RuntimeValue::Make<NumberValue>(lLeft << (lRight & 63));
+            case TokenType::BitwiseRightShift:      return RuntimeValue::Make<NumberValue>(lLeft >> (lRight & 63));
+            case TokenType::CompareEquals:
+            case TokenType::CompareStrictEquals:    return RuntimeValue::Make<NumberValue>(lLeft == lRight);
+            case TokenType::CompareNotEquals:
+            case TokenType::CompareStrictNotEquals: return RuntimeValue::Make<NumberValue>(lLeft != lRight);
+            case TokenType::CompareGreater:         return RuntimeValue::Make<NumberValue>(lLeft > lRight);
+            case TokenType::CompareLess:            return RuntimeValue::Make<NumberValue>(lLeft < lRight);
+            case TokenType::CompareGreaterEquals:   return RuntimeValue::Make<NumberValue>(lLeft >= lRight);
+            case TokenType::CompareLessEquals:      return RuntimeValue::Make<NumberValue>(lLeft <= lRight);
+            case TokenType::LogicalAnd:             return RuntimeValue::Make<NumberValue>(lLeft && lRight);
+            case TokenType::LogicalOr:              return RuntimeValue::Make<NumberValue>(lLeft || lRight);
+            default:
+                std::cerr << "[Interpreter] Un-implemented binary operator '" << lOperator.ToString()
+                          << "'." << std::endl;
+                return nullptr;
+        }
+    }
+
+    RuntimeValue::Ptr Interpreter::EvaluateUnary (const UnaryExpression::Ptr& pExpression)
+    {
+        auto lRighthand = Evaluate(pExpression->GetRighthandExpression());
+        if (lRighthand == nullptr) { return nullptr; }
+
+        const auto& lOperator = pExpression->GetOperatorToken();
+        if (lRighthand->GetValueType() != RuntimeValueType::Number)
+        {
+            std::cerr << "[Interpreter] Expected numeric operand in '" << lOperator.ToString()
+                      << "' expression." << std::endl;
+            return nullptr;
+        }
+
+        const tmc::Int64 lValue = RuntimeValue::Cast<NumberValue>(lRighthand)->GetValue();
+        switch (lOperator.mType)
+        {
+            case TokenType::Plus:       return lRighthand;
+            case TokenType::Minus:      return RuntimeValue::Make<NumberValue>(-lValue);
+            case TokenType::LogicalNot: return RuntimeValue::Make<NumberValue>(!lValue);
+            case TokenType::BitwiseNot: return RuntimeValue::Make<NumberValue>(~lValue);
+            default:
+                std::cerr << "[Interpreter] Un-implemented unary operator '" << lOperator.ToString()
+                          << "'." << std::endl;
+                return nullptr;
+        }
+    }
+
+    RuntimeValue::Ptr Interpreter::EvaluateIdentifier (const Identifier::Ptr& pExpression)
+    {
+        auto lValue = mEnvironment.Resolve(pExpression->GetSymbol());
+        if (lValue == nullptr)
+        {
+            std::cerr << "[Interpreter] Symbol '" << pExpression->GetSymbol() << "' is not defined."
+                      << std::endl;
+            return nullptr;
+        }
+
+        return lValue;
+    }
+
+    /* Private Methods - Code Emission ************************************************************/
+
+    tmc::Boolean Interpreter::IsConstant (const Expression::Ptr& pExpression) const
+    {
+        switch (pExpression->GetType())
+        {
+            case SyntaxType::NumericLiteral:
+            case SyntaxType::StringLiteral:
+                return true;
+            case SyntaxType::BinaryExpression:
+            {
+                auto lBinary = Expression::Cast<BinaryExpression>(pExpression);
+                return  IsConstant(lBinary->GetLefthandExpression()) &&
+                        IsConstant(lBinary->GetRighthandExpression());
+            }
+            case SyntaxType::UnaryExpression:
+                return IsConstant(Expression::Cast<UnaryExpression>(pExpression)->GetRighthandExpression());
+            default:
+                return false;
+        }
+    }
+
+    tmc::Boolean Interpreter::EvaluateInteger (const Expression::Ptr& pExpression, tmc::Int64& pValue)
+    {
+        auto lValue = Evaluate(pExpression);
+        if (lValue == nullptr)
+        {
+            return false;
+        }
+        else if (lValue->GetValueType() != RuntimeValueType::Number)
+        {
+            std::cerr << "[Interpreter] Expected a numeric expression." << std::endl;
+            return false;
+        }
+
+        pValue = RuntimeValue::Cast<NumberValue>(lValue)->GetValue();
+        return true;
+    }
+
+    Interpreter::Operand Interpreter::ClassifyOperand (const Expression::Ptr& pExpression) const
+    {
+        if (pExpression == nullptr)
+        {
+            return {};
+        }
+
+        switch (pExpression->GetType())
+        {
+            case SyntaxType::RegisterLiteral:
+                return { OperandKind::Register,
+                    Expression::Cast<RegisterLiteral>(pExpression)->GetRegisterType() };
+            case SyntaxType::ConditionLiteral:
+                return { OperandKind::Condition,
+                    Expression::Cast<ConditionLiteral>(pExpression)->GetConditionType() };
+            case SyntaxType::AddressExpression:
+            {
+                const auto& lInner = Expression::Cast<AddressExpression>(pExpression)->GetInnerExpression();
+                if (lInner->GetType() == SyntaxType::RegisterLiteral)
+                {
+                    return { OperandKind::Indirect,
+                        Expression::Cast<RegisterLiteral>(lInner)->GetRegisterType() };
+                }
+
+                return { OperandKind::Memory, 0, lInner };
+            }
+            default:
+                return { OperandKind::Immediate, 0, pExpression };
+        }
+    }
+
+    Fragment& Interpreter::PushFragment (const FragmentType& pType)
+    {
+        Fragment& lFragment = mSection->mFragments.emplace_back();
+        lFragment.mType = pType;
+        lFragment.mFile = mFile;
+        lFragment.mLine = mLine;
+
+        return lFragment;
+    }
+
+    tmc::Boolean Interpreter::EmitValue (Fragment& pFragment, const tmc::Index& pOffset,
+        const tmc::Index& pSize, const Expression::Ptr& pExpression, const tmc::Boolean& pRelative)
+    {
+        // Values naming a symbol, or relative to the fragment's own address, are patched in
+        // once the object has been laid out.
+        if (pRelative == true || IsConstant(pExpression) == false)
+        {
+            pFragment.mFixups.push_back({ pExpression, pOffset, pSize, pRelative });
+            return true;
+        }
+
+        tmc::Int64 lValue = 0;
+        if (EvaluateInteger(pExpression, lValue) == false)
+        {
+            return false;
+        }
+        else if (IsInRange(lValue, pSize, false) == false)
+        {
+            std::cerr << "[Interpreter] Value " << lValue << " does not fit in " << pSize
+                      << " byte(s)." << std::endl;
+            return false;
+        }
+
+        pFragment.Patch(pOffset, pSize, lValue);
+        return true;
+    }
+
+    tmc::Boolean Interpreter::EmitCode (const tmc::Uint8& pInstruction, const tmc::Uint8& pX,
+        const tmc::Uint8& pY, const Expression::Ptr& pImmediate, const tmc::Index& pImmediateSize,
+        const tmc::Boolean& pRelative)
+    {
+        Fragment& lFragment = PushFragment(FragmentType::Code);
+        lFragment.mBytes.resize(2 + pImmediateSize, 0);
+        lFragment.mBytes[0] = static_cast<tmc::Byte>(((pX & 0xF) << 4) | (pY & 0xF));
+        lFragment.mBytes[1] = pInstruction;
+
+        if (pImmediate != nullptr)
+        {
+            return EmitValue(lFragment, 2, pImmediateSize, pImmediate, pRelative);
+        }
+
+        return true;
+    }
+
+    tmc::Boolean Interpreter::EmitALU (const tmc::Uint8& pBase, const Operand& pFirst,
+        const Operand& pSecond)
+    {
+        // Arithmetic, bitwise and comparison instructions come in groups of three opcodes:
+        // 'OP X, I', 'OP X, Y' and 'OP X, [Y]'.
+        const auto lX = static_cast<tmc::Uint8>(pFirst.mId);
+        const auto lY = static_cast<tmc::Uint8>(pSecond.mId);
+
+        if (pFirst.mKind != OperandKind::Register)
+            { return false; }
+        else if (pSecond.mKind == OperandKind::Immediate)
+            { return EmitCode(pBase, lX, 0, pSecond.mExpression, GetRegisterSize(pFirst.mId)); }
+        else if (pSecond.mKind == OperandKind::Register)
+            { return EmitCode(pBase + 1, lX, lY); }
+        else if (pSecond.mKind == OperandKind::Indirect)
+            { return EmitCode(pBase + 2, lX, lY); }
+
+        return false;
+    }
+
+    tmc::Boolean Interpreter::EmitShift (const tmc::Uint8& pBase, const Operand& pFirst)
+    {
+        // Shift, rotate and swap instructions come in pairs of opcodes: 'OP X' and 'OP [X]'.
+        const auto lX = static_cast<tmc::Uint8>(pFirst.mId);
+
+        if (pFirst.mKind == OperandKind::Register)
+            { return EmitCode(pBase, lX, 0); }
+        else if (pFirst.mKind == OperandKind::Indirect)
+            { return EmitCode(pBase + 1, 0, lX); }
+
+        return false;
+    }
+
+    tmc::Boolean Interpreter::EmitBitCheck (const tmc::Uint8& pBase, const Operand& pFirst,
+        const Operand& pSecond)
+    {
+        // Bit instructions come in pairs of opcodes, 'OP X, Y' and 'OP X, [Y]', where 'X' is a
+        // constant bit index.
+        tmc::Int64 lBit = 0;
+        if (pFirst.mKind != OperandKind::Immediate || IsConstant(pFirst.mExpression) == false)
+        {
+            return false;
+        }
+        else if (EvaluateInteger(pFirst.mExpression, lBit) == false)
+        {
+            return false;
+        }
+        else if (lBit < 0 || lBit > 0xF)
+        {
+            std::cerr << "[Interpreter] Bit index " << lBit << " is out of range." << std::endl;
+            return false;
+        }
+
+        const auto lX = static_cast<tmc::Uint8>(lBit);
+        const auto lY = static_cast<tmc::Uint8>(pSecond.mId);
+
+        if (pSecond.mKind == OperandKind::Register)
+            { return EmitCode(pBase, lX, lY); }
+        else if (pSecond.mKind == OperandKind::Indirect)
+            { return EmitCode(pBase + 1, lX, lY); }
+
+        return false;
+    }
+
+    tmc::Boolean Interpreter::ResolveFixups (const FixupRun& pRun)
+    {
+        for (tmc::Index lIndex = pRun.mBegin; lIndex < pRun.mEnd; ++lIndex)
+        {
+            Fragment& lFragment = pRun.mSection->mFragments[lIndex];
+            for (const Fixup& lFixup : lFragment.mFixups)
+            {
+                if (ResolveFixup(lFragment, lFixup) == false)
+                {
+                    if (lFragment.mFile != tmc::NPOS)
+                    {
+                        std::cerr   << "[Interpreter]   In file '"
+                                    << mObject.GetFiles().at(lFragment.mFile).string() << ":"
+                                    << lFragment.mLine << "'." << std::endl;
+                    }
+
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    tmc::Boolean Interpreter::ResolveFixup (Fragment& pFragment, const Fixup& pFixup)
+    {
+        tmc::Int64 lValue = 0;
+        if (EvaluateInteger(pFixup.mExpression, lValue) == false)
+        {
+            return false;
+        }
+
+        if (pFixup.mRelative == true)
+        {
+            lValue -= static_cast<tmc::Int64>(pFragment.mAddress + pFragment.GetSize());
+        }
+
+        if (IsInRange(lValue, pFixup.mSize, pFixup.mRelative) == false)
+        {
+            std::cerr << "[Interpreter] Value " << lValue << " at address $" << std::hex
+                      << pFragment.mAddress << std::dec << " does not fit in " << pFixup.mSize
+                      << " byte(s)." << std::endl;
+            return false;
+        }
+
+        pFragment.Patch(pFixup.mOffset, pFixup.mSize, lValue);
+        return true;
+    }
+
 }
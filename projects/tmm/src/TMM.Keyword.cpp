@@ -12,6 +12,10 @@ namespace tmm
         { "", { KeywordType::None } },
 
         { "SECTION", { KeywordType::Language, LanguageType::LT_SECTION } },
+        { "MACRO", { KeywordType::Language, LanguageType::LT_MACRO } },
+        { "ENDM", { KeywordType::Language, LanguageType::LT_ENDM } },
+        { "INCLUDE", { KeywordType::Language, LanguageType::LT_INCLUDE } },
+        { "INCBIN", { KeywordType::Language, LanguageType::LT_INCBIN } },
 
         { "METADATA", { KeywordType::Section, SectionType::ST_METADATA } },
         { "RST0", { KeywordType::Section, SectionType::ST_RST_0 } },
@@ -129,6 +133,15 @@ namespace tmm
         { "SWAP", { KeywordType::Instruction, InstructionType::IT_SWAP, 1 } }
     };
 
+    // The data directives. 'DW' and 'DL' are also register names, so these are only looked up at
+    // the start of a statement, and never take the place of a register in an operand.
+    static const tmc::Dictionary<Keyword> DIRECTIVE_LOOKUP = {
+        { "DB", { KeywordType::Language, LanguageType::LT_DB } },
+        { "DW", { KeywordType::Language, LanguageType::LT_DW } },
+        { "DL", { KeywordType::Language, LanguageType::LT_DL } },
+        { "DS", { KeywordType::Language, LanguageType::LT_DS } }
+    };
+
     /* Public Methods *****************************************************************************/
 
     const Keyword& Keyword::Lookup (const tmc::String& pKeyword)
@@ -137,4 +150,10 @@ namespace tmm
         return (lIter != KEYWORD_LOOKUP.end()) ? lIter->second : KEYWORD_LOOKUP.at("");
     }
 
+    const Keyword& Keyword::LookupDirective (const tmc::String& pKeyword)
+    {
+        auto lIter = DIRECTIVE_LOOKUP.find(pKeyword);
+        return (lIter != DIRECTIVE_LOOKUP.end()) ? lIter->second : KEYWORD_LOOKUP.at("");
+    }
+
 }
@@ -6,6 +6,12 @@
 namespace tmm
 {
 
+    /* Static Members *****************************************************************************/
+
+    tmc::Boolean                    Lexer::sModuleCaching = false;
+    std::mutex                      Lexer::sModuleMutex;
+    tmc::Dictionary<Lexer::Entry>   Lexer::sModules;
+
     /* Public Constructors and Destructor *********************************************************/
 
     Lexer::Lexer ()
@@ -20,6 +26,19 @@ namespace tmm
 
     /* Public Methods *****************************************************************************/
 
+    void Lexer::Reset ()
+    {
+        mTokens.clear();
+        mTokenPointer = 0;
+        mReadPointer = 0;
+        mCurrentFile.clear();
+        mCurrentLine = 0;
+        mLexedPaths.clear();
+        mIncludeDepth = 0;
+        mSources.clear();
+        mFailed = false;
+    }
+
     void Lexer::ListTokens () const
     {
         for (tmc::Index lIndex = 0; lIndex < mTokens.size(); ++lIndex)
@@ -36,29 +55,33 @@ namespace tmm
         }
     }
 
-    tmc::Boolean Lexer::HasMoreTokens () const
+    tmc::Boolean Lexer::HasMoreTokens ()
     {
-        return  mTokens.empty() == false &&
-                mTokens.front().mType != TokenType::EndOfFile;
+        return  Fill(0) == true && mReadPointer < mTokens.size() &&
+                mTokens[mReadPointer].mType != TokenType::EndOfFile;
     }
 
-    const Token& Lexer::TokenAt (const tmc::Index& pIndex) const
+    const Token& Lexer::TokenAt (const tmc::Index& pIndex)
     {
-        if (pIndex >= mTokens.size())
+        Fill(pIndex);
+        if (mReadPointer + pIndex >= mTokens.size())
         {
             std::cerr << "[Lexer] Token index " << pIndex << " is out of range!" << std::endl;
             throw std::out_of_range { "Token index out of range!" };
         }
 
-        return mTokens.at(pIndex);
+        return mTokens[mReadPointer + pIndex];
     }
 
     Token Lexer::DiscardToken ()
     {
-        Token lDiscardedToken = mTokens.front();
-        if (mTokens.size() > 1 && lDiscardedToken.mType != TokenType::EndOfFile)
+        // Tokens are consumed by moving the read pointer past them, rather than erasing them
+        // from the front of the list.
+        Token lDiscardedToken = TokenAt();
+        if (Fill(1) == true && mReadPointer + 1 < mTokens.size() &&
+            lDiscardedToken.mType != TokenType::EndOfFile)
         {
-            mTokens.erase(mTokens.begin());
+            mReadPointer++;
         }
 
         return lDiscardedToken;
@@ -66,11 +89,11 @@ namespace tmm
 
     tmc::Boolean Lexer::DiscardTokenIf (const TokenType& pType)
     {
-        if (mTokens.front().mType == pType)
+        if (TokenAt().mType == pType)
         {
-            if (mTokens.size() > 1)
+            if (Fill(1) == true && mReadPointer + 1 < mTokens.size())
             {
-                mTokens.erase(mTokens.begin());
+                mReadPointer++;
             }
 
             return true;
@@ -79,6 +102,15 @@ namespace tmm
         return false;
     }
 
+    void Lexer::ReleaseTokens ()
+    {
+        // Tokens behind the read pointer are never looked at again. This is only called between
+        // statements, so no token the parser still refers to is released.
+        mTokens.erase(mTokens.begin(), mTokens.begin() + mReadPointer);
+        mTokenPointer -= std::min(mTokenPointer, mReadPointer);
+        mReadPointer = 0;
+    }
+
     tmc::Boolean Lexer::TokenizeFile (const tmc::Path& pPath)
     {
         if (pPath.empty() == true)
@@ -102,26 +134,247 @@ namespace tmm
             mLexedPaths.insert(lFullPath);
         }
 
-        std::fstream lFile { lFullPath, std::ios::in };
-        if (lFile.is_open() == false)
+        Module lModule = LoadModule(lFullPath);
+        if (lModule == nullptr)
         {
-            std::cerr << "[Lexer] File '" << lFullPath.string() << "' could not be opened." << std::endl;
             return false;
         }
 
-        mCurrentFile = lFullPath;
-        mCurrentLine = 1;
+        // Splice the file's tokens in at the insertion point. A string following 'include' names
+        // a file, relative to this one, whose tokens are spliced in its place.
+        for (tmc::Index lIndex = 0; lIndex < lModule->size(); ++lIndex)
+        {
+            const Token& lToken = lModule->at(lIndex);
+            if (lToken.mType != TokenType::Keyword || lToken.mValue != "INCLUDE")
+            {
+                mTokens.insert(mTokens.begin() + (mTokenPointer++), lToken);
+                continue;
+            }
 
-        tmc::Boolean lResult = TokenizeStream(lFile);
-        if (lResult == false)
+            if (lIndex + 1 >= lModule->size() || lModule->at(lIndex + 1).mType != TokenType::String)
+            {
+                std::cerr   << "[Lexer] Expected a file name after 'include'." << std::endl;
+                std::cerr   << "[Lexer]   In source file '" << lFullPath.string() << ":" << lToken.mLine
+                            << "'" << std::endl;
+                return false;
+            }
+
+            mIncludeDepth++;
+            tmc::Boolean lResult = TokenizeFile(lFullPath.parent_path() / lModule->at(++lIndex).mValue);
+            mIncludeDepth--;
+
+            if (lResult == false)
+            {
+                std::cerr   << "[Lexer]   Included from '" << lFullPath.string() << ":" << lToken.mLine
+                            << "'" << std::endl;
+                return false;
+            }
+        }
+
+        // Only the outermost file ends the token stream.
+        if (mIncludeDepth == 0)
         {
-            std::cerr << "[Lexer]   In source file '" << lFullPath.string() << "'" << std::endl;
+            mCurrentFile = lFullPath;
+            mCurrentLine = (lModule->empty() == true) ? 1 : lModule->back().mLine;
+            return InsertToken(TokenType::EndOfFile);
         }
 
-        return lResult;
+        return true;
     }
 
     tmc::Boolean Lexer::TokenizeStream (std::istream& pStream)
+    {
+        tmc::Boolean lEnd = false;
+        while (lEnd == false)
+        {
+            if (TokenizeNext(pStream, lEnd) == false)
+            {
+                return false;
+            }
+        }
+
+        // Only the outermost file ends the token stream.
+        return (mIncludeDepth == 0) ? InsertToken(TokenType::EndOfFile) : true;
+    }
+
+    tmc::Boolean Lexer::OpenFile (const tmc::Path& pPath)
+    {
+        if (pPath.empty() == true)
+        {
+            std::cerr << "[Lexer] No input file provided." << std::endl;
+            return false;
+        }
+
+        // The file is lexed as its tokens are asked for, rather than all at once, so that only
+        // the tokens of the statement being parsed need be held.
+        tmc::Path lFullPath = fs::absolute(pPath).lexically_normal();
+        if (fs::exists(lFullPath) == false)
+        {
+            std::cerr << "[Lexer] File '" << lFullPath.string() << "' not found." << std::endl;
+            return false;
+        }
+
+        mLexedPaths.insert(lFullPath);
+        return OpenSource(lFullPath);
+    }
+
+    /* Public Static Methods **********************************************************************/
+
+    void Lexer::SetModuleCaching (const tmc::Boolean& pEnabled)
+    {
+        std::lock_guard lLock { sModuleMutex };
+
+        sModuleCaching = pEnabled;
+        if (pEnabled == false)
+        {
+            sModules.clear();
+        }
+    }
+
+    /* Private Methods ****************************************************************************/
+
+    Lexer::Module Lexer::LoadModule (const tmc::Path& pPath)
+    {
+        // With caching on, a file's tokens are reused for as long as the file is unchanged.
+        std::error_code lError;
+        const fs::file_time_type lModified = fs::last_write_time(pPath, lError);
+        const tmc::Uint64 lSize = fs::file_size(pPath, lError);
+
+        if (!lError)
+        {
+            std::lock_guard lLock { sModuleMutex };
+
+            auto lIter = sModules.find(pPath.string());
+            if (lIter != sModules.end() && lIter->second.mModified == lModified && lIter->second.mSize == lSize)
+            {
+                return lIter->second.mModule;
+            }
+        }
+
+        std::fstream lFile { pPath, std::ios::in };
+        if (lFile.is_open() == false)
+        {
+            std::cerr << "[Lexer] File '" << pPath.string() << "' could not be opened." << std::endl;
+            return nullptr;
+        }
+
+        // The file is lexed on its own, without an end-of-file token; includes are expanded
+        // when it is spliced in.
+        Lexer lFileLexer;
+        lFileLexer.mCurrentFile = pPath;
+        lFileLexer.mCurrentLine = 1;
+        lFileLexer.mIncludeDepth = 1;
+
+        if (lFileLexer.TokenizeStream(lFile) == false)
+        {
+            std::cerr << "[Lexer]   In source file '" << pPath.string() << "'" << std::endl;
+            return nullptr;
+        }
+
+        Module lModule = std::make_shared<const tmc::List<Token>>(
+            std::make_move_iterator(lFileLexer.mTokens.begin()),
+            std::make_move_iterator(lFileLexer.mTokens.end()));
+        if (!lError)
+        {
+            std::lock_guard lLock { sModuleMutex };
+            if (sModuleCaching == true)
+            {
+                sModules[pPath.string()] = { lModified, lSize, lModule };
+            }
+        }
+
+        return lModule;
+    }
+
+    tmc::Boolean Lexer::OpenSource (const tmc::Path& pPath)
+    {
+        auto lStream = std::make_unique<std::fstream>(pPath, std::ios::in);
+        if (lStream->is_open() == false)
+        {
+            std::cerr << "[Lexer] File '" << pPath.string() << "' could not be opened." << std::endl;
+            return false;
+        }
+
+        mSources.push_back({ std::move(lStream), pPath, 1 });
+        return true;
+    }
+
+    tmc::Boolean Lexer::Fill (const tmc::Index& pIndex)
+    {
+        // Lex from the innermost open file until the token at the given index past the read
+        // pointer exists, or until every file has ended.
+        while (mReadPointer + pIndex >= mTokens.size() && mSources.empty() == false)
+        {
+            tmc::Boolean lEnd = false;
+            tmc::Boolean lGood = false;
+
+            mCurrentFile = mSources.back().mPath;
+            mCurrentLine = mSources.back().mLine;
+            lGood = TokenizeNext(*mSources.back().mStream, lEnd);
+
+            // An include names a file, relative to this one, whose tokens are streamed in its place.
+            tmc::Path lInclude = "";
+            if (lGood == true && lEnd == false && mTokens.back().mType == TokenType::Keyword &&
+                mTokens.back().mValue == "INCLUDE")
+            {
+                lGood = TokenizeNext(*mSources.back().mStream, lEnd);
+                if (lGood == false || lEnd == true || mTokens.back().mType != TokenType::String)
+                {
+                    std::cerr << "[Lexer] Expected a file name after 'include'." << std::endl;
+                    lGood = false;
+                }
+                else
+                {
+                    lInclude = fs::absolute(mCurrentFile.parent_path() / mTokens.back().mValue).lexically_normal();
+                    mTokens.erase(mTokens.end() - 2, mTokens.end());
+                    mTokenPointer -= 2;
+                }
+            }
+
+            mSources.back().mLine = mCurrentLine;
+
+            if (lGood == true && lInclude.empty() == false && mLexedPaths.contains(lInclude) == false)
+            {
+                if (fs::exists(lInclude) == false)
+                {
+                    std::cerr << "[Lexer] File '" << lInclude.string() << "' not found." << std::endl;
+                    lGood = false;
+                }
+                else
+                {
+                    mLexedPaths.insert(lInclude);
+                    lGood = OpenSource(lInclude);
+                }
+            }
+
+            // A failure ends the stream early; the caller learns of it through 'IsGood'.
+            if (lGood == false)
+            {
+                std::cerr   << "[Lexer]   In source file '" << mCurrentFile.string() << ":"
+                            << mCurrentLine << "'" << std::endl;
+                mFailed = true;
+                mSources.clear();
+                InsertToken(TokenType::EndOfFile);
+                return false;
+            }
+
+            // Only the outermost file ends the token stream.
+            if (lEnd == true)
+            {
+                mSources.pop_back();
+                if (mSources.empty() == true)
+                {
+                    InsertToken(TokenType::EndOfFile);
+                }
+            }
+        }
+
+        return mFailed == false;
+    }
+
+    /* Private Methods - Tokenization *************************************************************/
+
+    tmc::Boolean Lexer::TokenizeNext (std::istream& pStream, tmc::Boolean& pEnd)
     {
         tmc::Int32      lCharacter = 0;
         tmc::Boolean    lIsComment = false;
@@ -133,7 +386,8 @@ namespace tmm
 
             if (lCharacter == std::char_traits<char>::eof())
             {
-                return InsertToken(TokenType::EndOfFile);
+                pEnd = true;
+                return true;
             }
 
             if (lCharacter == '\n')
@@ -171,13 +425,12 @@ namespace tmm
             if (lIsGood == false)
             {
                 std::cerr << "[Lexer]   At line #" << mCurrentLine << std::endl;
-                return false;
             }
+
+            return lIsGood;
         }
     }
 
-    /* Private Methods - Tokenization *************************************************************/
-
     tmc::Boolean Lexer::InsertToken (const TokenType& pType, const tmc::String& pValue)
     {
         mTokens.emplace(mTokens.begin() + (mTokenPointer++), pType, pValue, mCurrentFile,
@@ -322,7 +575,7 @@ namespace tmm
         
         pCharacter = pStream.get();
 
-        while (pCharacter >= '0' || pCharacter <= '7')
+        while (pCharacter >= '0' && pCharacter <= '7')
         {
             lValue += static_cast<char>(pCharacter);
             pCharacter = pStream.get();
@@ -0,0 +1,295 @@
+/// @file TMM.Macro.cpp
+
+#include <TMM.Precompiled.hpp>
+#include <TMM.Macro.hpp>
+
+namespace tmm
+{
+
+    /* Public Constructors and Destructor *********************************************************/
+
+    Macro::Macro (const MacroStatement::Ptr& pStatement) :
+        mStatement  { pStatement }
+    {
+        const auto& lBody = mStatement->GetBody();
+
+        // Labels defined inside the body are local to each expansion.
+        for (const auto& lStatement : lBody)
+        {
+            if (lStatement->GetType() != SyntaxType::LabelStatement) { continue; }
+
+            const auto& lExpression = Statement::Cast<LabelStatement>(lStatement)->GetExpression();
+            if (lExpression->GetType() == SyntaxType::Identifier)
+            {
+                mLocalLabels.insert(Expression::Cast<Identifier>(lExpression)->GetSymbol());
+            }
+        }
+
+        // Statements which name neither a placeholder nor a local label come out the same in
+        // every expansion, so they are shared rather than copied.
+        mInvariant.reserve(lBody.size());
+        for (const auto& lStatement : lBody)
+        {
+            mInvariant.push_back(IsInvariant(lStatement));
+        }
+    }
+
+    /* Public Methods *****************************************************************************/
+
+    tmc::Boolean Macro::Expand (const Expression::Body& pArguments, const tmc::Index& pExpansion,
+        Statement::Body& pBody) const
+    {
+        // Local labels are suffixed with '@' and the expansion number. '@' cannot appear in an
+        // identifier, so the renamed labels can never collide with a user's symbols.
+        const Context lContext { pArguments, "@" + std::to_string(pExpansion) };
+        const auto& lBody = mStatement->GetBody();
+
+        pBody.reserve(pBody.size() + lBody.size());
+        for (tmc::Index lIndex = 0; lIndex < lBody.size(); ++lIndex)
+        {
+            if (mInvariant[lIndex] == true)
+            {
+                pBody.push_back(lBody[lIndex]);
+                continue;
+            }
+
+            Statement::Ptr lStatement = Instantiate(lBody[lIndex], lContext);
+            if (lStatement == nullptr)
+            {
+                std::cerr << "[Macro]   In expansion of macro '" << GetName() << "', at '"
+                          << lBody[lIndex]->GetFilePath().string() << ":" << lBody[lIndex]->GetLine()
+                          << "'." << std::endl;
+                return false;
+            }
+
+            // Expanded statements keep the location of the line they came from.
+            lStatement->SetLocation(lBody[lIndex]->GetFile(), lBody[lIndex]->GetLine());
+            pBody.push_back(lStatement);
+        }
+
+        return true;
+    }
+
+    /* Private Methods ****************************************************************************/
+
+    tmc::Boolean Macro::IsInvariant (const Statement::Ptr& pStatement) const
+    {
+        if (pStatement == nullptr)
+        {
+            return true;
+        }
+
+        switch (pStatement->GetType())
+        {
+            case SyntaxType::LabelStatement:
+                return IsInvariant(Statement::Cast<LabelStatement>(pStatement)->GetExpression());
+            case SyntaxType::DataStatement:
+            {
+                const auto& lBody = Statement::Cast<DataStatement>(pStatement)->GetExpressionBody();
+                return std::all_of(lBody.begin(), lBody.end(),
+                    [this] (const Expression::Ptr& pExpression) { return IsInvariant(pExpression); });
+            }
+            case SyntaxType::InstructionStatement:
+            {
+                auto lInstruction = Statement::Cast<InstructionStatement>(pStatement);
+                return  IsInvariant(lInstruction->GetFirstOperandExpression()) &&
+                        IsInvariant(lInstruction->GetSecondOperandExpression());
+            }
+            case SyntaxType::MacroCallStatement:
+            {
+                const auto& lArguments = Statement::Cast<MacroCallStatement>(pStatement)->GetArguments();
+                return std::all_of(lArguments.begin(), lArguments.end(),
+                    [this] (const Expression::Ptr& pExpression) { return IsInvariant(pExpression); });
+            }
+            case SyntaxType::IncbinStatement:
+            {
+                auto lIncbin = Statement::Cast<IncbinStatement>(pStatement);
+                return  IsInvariant(lIncbin->GetOffsetExpression()) &&
+                        IsInvariant(lIncbin->GetLengthExpression());
+            }
+            case SyntaxType::BinaryExpression:
+            {
+                auto lBinary = Statement::Cast<BinaryExpression>(pStatement);
+                return  IsInvariant(lBinary->GetLefthandExpression()) &&
+                        IsInvariant(lBinary->GetRighthandExpression());
+            }
+            case SyntaxType::UnaryExpression:
+                return IsInvariant(Statement::Cast<UnaryExpression>(pStatement)->GetRighthandExpression());
+            case SyntaxType::AddressExpression:
+                return IsInvariant(Statement::Cast<AddressExpression>(pStatement)->GetInnerExpression());
+            case SyntaxType::Identifier:
+                return mLocalLabels.contains(Statement::Cast<Identifier>(pStatement)->GetSymbol()) == false;
+            case SyntaxType::PlaceholderLiteral:
+                return false;
+            default:
+                return true;
+        }
+    }
+
+    Statement::Ptr Macro::Instantiate (const Statement::Ptr& pStatement, const Context& pContext) const
+    {
+        switch (pStatement->GetType())
+        {
+            case SyntaxType::LabelStatement:
+            {
+                auto lExpression = Instantiate(Statement::Cast<LabelStatement>(pStatement)->GetExpression(), pContext);
+                if (lExpression == nullptr) { return nullptr; }
+
+                return Statement::Make<LabelStatement>(lExpression);
+            }
+            case SyntaxType::DataStatement:
+            {
+                auto lData = Statement::Cast<DataStatement>(pStatement);
+                auto lCopy = Statement::Make<DataStatement>(lData->GetDataType());
+                const auto& lBytes = lData->GetBytes();
+                const auto& lOffsets = lData->GetOffsets();
+                tmc::Index lCopied = 0;
+
+                for (tmc::Index lIndex = 0; lIndex < lOffsets.size(); ++lIndex)
+                {
+                    auto lExpression = Instantiate(lData->GetExpressionBody()[lIndex], pContext);
+                    if (lExpression == nullptr) { return nullptr; }
+
+                    lCopy->PushBytes(lBytes.data() + lCopied, lOffsets[lIndex] - lCopied);
+                    lCopy->PushExpression(lExpression);
+                    lCopied = lOffsets[lIndex];
+                }
+
+                lCopy->PushBytes(lBytes.data() + lCopied, lBytes.size() - lCopied);
+                return lCopy;
+            }
+            case SyntaxType::InstructionStatement:
+            {
+                auto lInstruction = Statement::Cast<InstructionStatement>(pStatement);
+                Expression::Ptr lFirst = nullptr, lSecond = nullptr;
+
+                if (lInstruction->GetFirstOperandExpression() != nullptr)
+                {
+                    lFirst = Instantiate(lInstruction->GetFirstOperandExpression(), pContext);
+                    if (lFirst == nullptr) { return nullptr; }
+                }
+
+                if (lInstruction->GetSecondOperandExpression() != nullptr)
+                {
+                    lSecond = Instantiate(lInstruction->GetSecondOperandExpression(), pContext);
+                    if (lSecond == nullptr) { return nullptr; }
+                }
+
+                return Statement::Make<InstructionStatement>(lInstruction->GetInstructionType(),
+                    lFirst, lSecond);
+            }
+            case SyntaxType::MacroCallStatement:
+            {
+                auto lCall = Statement::Cast<MacroCallStatement>(pStatement);
+                Expression::Body lArguments;
+                lArguments.reserve(lCall->GetArguments().size());
+
+                for (const auto& lArgument : lCall->GetArguments())
+                {
+                    auto lExpression = Instantiate(lArgument, pContext);
+                    if (lExpression == nullptr) { return nullptr; }
+
+                    lArguments.push_back(lExpression);
+                }
+
+                return Statement::Make<MacroCallStatement>(lCall->GetName(), lArguments);
+            }
+            case SyntaxType::IncbinStatement:
+            {
+                auto lIncbin = Statement::Cast<IncbinStatement>(pStatement);
+                Expression::Ptr lOffset = nullptr, lLength = nullptr;
+
+                if (lIncbin->GetOffsetExpression() != nullptr)
+                {
+                    lOffset = Instantiate(lIncbin->GetOffsetExpression(), pContext);
+                    if (lOffset == nullptr) { return nullptr; }
+                }
+
+                if (lIncbin->GetLengthExpression() != nullptr)
+                {
+                    lLength = Instantiate(lIncbin->GetLengthExpression(), pContext);
+                    if (lLength == nullptr) { return nullptr; }
+                }
+
+                return Statement::Make<IncbinStatement>(lIncbin->GetPath(), lOffset, lLength);
+            }
+            default:
+                return pStatement;
+        }
+    }
+
+    Expression::Ptr Macro::Instantiate (const Expression::Ptr& pExpression, const Context& pContext) const
+    {
+        // Only the nodes on the path to a placeholder or a local label are copied; every other
+        // sub-tree is shared with the macro's body.
+        switch (pExpression->GetType())
+        {
+            case SyntaxType::BinaryExpression:
+            {
+                auto lBinary = Expression::Cast<BinaryExpression>(pExpression);
+                auto lLefthand = Instantiate(lBinary->GetLefthandExpression(), pContext);
+                auto lRighthand = Instantiate(lBinary->GetRighthandExpression(), pContext);
+                if (lLefthand == nullptr || lRighthand == nullptr) { return nullptr; }
+
+                if (lLefthand == lBinary->GetLefthandExpression() &&
+                    lRighthand == lBinary->GetRighthandExpression())
+                {
+                    return pExpression;
+                }
+
+                return Expression::Make<BinaryExpression>(lLefthand, lRighthand, lBinary->GetOperatorToken());
+            }
+            case SyntaxType::UnaryExpression:
+            {
+                auto lUnary = Expression::Cast<UnaryExpression>(pExpression);
+                auto lRighthand = Instantiate(lUnary->GetRighthandExpression(), pContext);
+                if (lRighthand == nullptr) { return nullptr; }
+
+                if (lRighthand == lUnary->GetRighthandExpression())
+                {
+                    return pExpression;
+                }
+
+                return Expression::Make<UnaryExpression>(lRighthand, lUnary->GetOperatorToken());
+            }
+            case SyntaxType::AddressExpression:
+            {
+                auto lAddress = Expression::Cast<AddressExpression>(pExpression);
+                auto lInner = Instantiate(lAddress->GetInnerExpression(), pContext);
+                if (lInner == nullptr) { return nullptr; }
+
+                if (lInner == lAddress->GetInnerExpression())
+                {
+                    return pExpression;
+                }
+
+                return Expression::Make<AddressExpression>(lInner);
+            }
+            case SyntaxType::Identifier:
+            {
+                const auto& lSymbol = Expression::Cast<Identifier>(pExpression)->GetSymbol();
+                if (mLocalLabels.contains(lSymbol) == false)
+                {
+                    return pExpression;
+                }
+
+                return Expression::Make<Identifier>(lSymbol + pContext.mSuffix);
+            }
+            case SyntaxType::PlaceholderLiteral:
+            {
+                auto lSlot = Expression::Cast<PlaceholderLiteral>(pExpression)->GetSlot();
+                if (lSlot >= pContext.mArguments.size())
+                {
+                    std::cerr << "[Macro] Placeholder '@" << lSlot << "' has no matching argument; "
+                              << pContext.mArguments.size() << " given." << std::endl;
+                    return nullptr;
+                }
+
+                return pContext.mArguments[lSlot];
+            }
+            default:
+                return pExpression;
+        }
+    }
+
+}
@@ -2,44 +2,319 @@
 
 #include <TMM.Precompiled.hpp>
 #include <TMM.Interpreter.hpp>
+#include <TMM.Optimizer.hpp>
+#include <TMM.Collector.hpp>
+#include <TMM.Merger.hpp>
+#include <TMM.Writer.hpp>
+#include <TMM.Cache.hpp>
+#include <TMM.Server.hpp>
+#include <TMM.Stats.hpp>
 #include <TMC.Arguments.hpp>
 
-tmc::Int32 RunAssembler ()
+tmc::Int32 AssembleFile (tmm::Lexer& pLexer, tmm::Parser& pParser, const tmc::String& pInputFile,
+    const tmc::String& pOutputFile, const tmc::Index& pJobs)
 {
-    tmc::String         lInputFile  = tmc::Arguments::Get("input-file", 'i');
-    tmc::String         lOutputFile = tmc::Arguments::Get("output-file", 'o');
+    tmc::String         lOutputFile = pOutputFile;
     tmc::Boolean        lLexOnly    = tmc::Arguments::Has("lex-only", 'l');
-    tmm::Lexer          lLexer;
-    tmm::Parser         lParser;
+    tmc::Boolean        lOptimize   = tmc::Arguments::Has("optimize", 'O');
+    tmc::Boolean        lStream     = tmc::Arguments::Has("stream", 't');
+    tmc::Boolean        lCollect    = tmc::Arguments::Has("gc-sections", 'G');
+    tmc::Boolean        lMerge      = tmc::Arguments::Has("merge-data", 'D');
+    tmc::String         lName       = tmc::Arguments::Get("name", 'n');
+    tmc::String         lAuthor     = tmc::Arguments::Get("author", 'u');
+    tmc::String         lRAMSize    = tmc::Arguments::Get("ram-size", 'r', "0");
+    tmc::Boolean        lWriteMap   = tmc::Arguments::Has("map", 'm');
+    tmc::String         lMapFile    = tmc::Arguments::Get("map", 'm');
+    tmc::Boolean        lWriteLines = tmc::Arguments::Has("line-table", 'g');
+    tmc::String         lLinesFile  = tmc::Arguments::Get("line-table", 'g');
+    tmc::Boolean        lWriteCode  = tmc::Arguments::Has("code-map", 'k');
+    tmc::String         lCodeFile   = tmc::Arguments::Get("code-map", 'k');
+    tmc::String         lCacheDir   = tmc::Arguments::Get("cache-dir", 'c');
+    tmc::Boolean        lWantStats  = tmc::Arguments::Has("stats", 'S');
+    tmc::String         lStatsType  = tmc::Arguments::Get("stats", 'S');
     tmm::Object         lObject;
-    tmm::Interpreter    lInterpreter { lLexer, lParser, lObject };
+    tmm::Interpreter    lInterpreter { pLexer, pParser, lObject };
+
+    lInterpreter.SetJobs(pJobs);
+
+    // Unless given, the ROM image is named after the input file, as is the program itself. The
+    // map file, line table and code map sit alongside the ROM image.
+    if (lOutputFile.empty() == true)
+    {
+        lOutputFile = tmc::Path { pInputFile }.replace_extension(".tm").string();
+    }
+
+    if (lName.empty() == true)
+    {
+        lName = tmc::Path { pInputFile }.stem().string();
+    }
+
+    if (lWriteMap == true && lMapFile.empty() == true)
+    {
+        lMapFile = tmc::Path { lOutputFile }.replace_extension(".map").string();
+    }
+
+    if (lWriteLines == true && lLinesFile.empty() == true)
+    {
+        lLinesFile = tmc::Path { lOutputFile }.replace_extension(".tml").string();
+    }
+
+    if (lWriteCode == true && lCodeFile.empty() == true)
+    {
+        lCodeFile = tmc::Path { lOutputFile }.replace_extension(".tcm").string();
+    }
+
+    tmm::StatsFormat lStatsFormat = tmm::StatsFormat::None;
+    if (lWantStats == true)
+    {
+        lStatsFormat = tmm::Stats::ParseFormat(lStatsType);
+        if (lStatsFormat == tmm::StatsFormat::None)
+        {
+            std::cerr << "[AssembleFile] Invalid statistics format: '" << lStatsType << "'." << std::endl;
+            return 1;
+        }
+    }
 
-    if (lInputFile.empty() == true)
+    tmc::Char* lEnd = nullptr;
+    tmc::Uint64 lRequestedRAM = std::strtoull(lRAMSize.c_str(), &lEnd, 0);
+    if (lEnd == lRAMSize.c_str() || *lEnd != '\0' || lRequestedRAM > (tmc::RAM_END - tmc::RAM_START) + 1ULL)
+    {
+        std::cerr << "[AssembleFile] Invalid RAM size: '" << lRAMSize << "'." << std::endl;
+        return 1;
+    }
+
+    // Every option which affects the output is part of the cache key; the output paths are not.
+    tmc::List<tmm::Cache::Artifact> lArtifacts { { "rom", lOutputFile } };
+    if (lWriteMap == true)      { lArtifacts.push_back({ "map", lMapFile }); }
+    if (lWriteLines == true)    { lArtifacts.push_back({ "tml", lLinesFile }); }
+    if (lWriteCode == true)     { lArtifacts.push_back({ "tcm", lCodeFile }); }
+
+    const tmc::String lOptions =
+        "optimize=" + std::to_string(lOptimize) + "\ngc-sections=" + std::to_string(lCollect) +
+        "\nmerge-data=" + std::to_string(lMerge) + "\nname=" + lName + "\nauthor=" + lAuthor +
+        "\nram-size=" + std::to_string(lRequestedRAM) + "\nmap=" + std::to_string(lWriteMap) +
+        "\nline-table=" + std::to_string(lWriteLines) + "\ncode-map=" + std::to_string(lWriteCode);
+
+    // Each phase is measured from the end of the one before it. Statistics are only reported for
+    // builds which succeed.
+    tmm::Stats lStats { pInputFile, lStatsFormat };
+
+    tmm::Cache lCache { lCacheDir };
+    if (lCacheDir.empty() == false && lLexOnly == false)
+    {
+        tmc::Boolean lHit = lCache.Lookup(pInputFile, lOptions, lArtifacts);
+        lStats.End("cache", (lHit == true) ? lArtifacts.size() : 0, "artifacts");
+
+        if (lHit == true)
+        {
+            lStats.Report();
+            return 0;
+        }
+    }
+
+    if (lStream == true && lLexOnly == false)
+    {
+        // Lexing, parsing and evaluation are interleaved a statement at a time, and so are
+        // measured as one phase.
+        if (pLexer.OpenFile(pInputFile) == false)
+        {
+            return 2;
+        }
+
+        if (lInterpreter.RunStreaming() == false)
+        {
+            return (pLexer.IsGood() == true) ? 5 : 2;
+        }
+
+        lStats.End("stream", lObject.GetSize(), "bytes");
+    }
+    else
+    {
+        if (pLexer.TokenizeFile(pInputFile) == false)
+        {
+            return 2;
+        }
+
+        lStats.End("lex", pLexer.GetTokenCount(), "tokens");
+
+        if (lLexOnly == true)
+        {
+            pLexer.ListTokens();
+            lStats.Report();
+            return 0;
+        }
+
+        const tmc::Index lNodeCount = tmm::Statement::GetCreatedCount();
+        tmm::Program::Ptr lProgram = pParser.ParseProgram(pLexer);
+        if (lProgram == nullptr)
+        {
+            return 4;
+        }
+
+        lStats.End("parse", tmm::Statement::GetCreatedCount() - lNodeCount, "nodes");
+
+        if (lInterpreter.Run(lProgram) == false)
+        {
+            return 5;
+        }
+
+        lStats.End("evaluate", lObject.GetSize(), "bytes");
+    }
+
+    if (lOptimize == true)
+    {
+        tmm::Optimizer lOptimizer { lObject };
+        tmc::Index lRewrites = lOptimizer.Run();
+        lStats.End("optimize", lRewrites, "rewrites");
+    }
+
+    if (lMerge == true)
+    {
+        tmm::Merger lMerger { lObject };
+        tmc::Index lSaved = lMerger.Run();
+        lStats.End("merge", lSaved, "bytes");
+    }
+
+    if (lCollect == true)
+    {
+        tmm::Collector lCollector { lObject };
+        tmc::Index lRemoved = lCollector.Run();
+        lStats.End("collect", lRemoved, "bytes");
+    }
+
+    if (lInterpreter.Link() == false)
+    {
+        return 6;
+    }
+
+    lStats.End("link", lInterpreter.GetFixupCount(), "fixups");
+
+    tmm::Writer lWriter { lObject };
+    lWriter.SetProgramName(lName);
+    lWriter.SetProgramAuthor(lAuthor);
+    lWriter.SetRequestedRAMSize(static_cast<tmc::Long>(std::min<tmc::Uint64>(lRequestedRAM, 0xFFFFFFFF)));
+    if (lWriter.WriteROM(lOutputFile) == false)
+    {
+        return 7;
+    }
+
+    if (lWriteMap == true && lWriter.WriteMap(lMapFile) == false)
+    {
+        return 8;
+    }
+
+    if (lWriteLines == true && lWriter.WriteLineTable(lLinesFile) == false)
+    {
+        return 8;
+    }
+
+    if (lWriteCode == true && lWriter.WriteCodeMap(lCodeFile) == false)
+    {
+        return 8;
+    }
+
+    // A failure to populate the cache only costs the next build its hit.
+    if (lCacheDir.empty() == false)
+    {
+        tmc::Set<tmc::Path> lDependencies = pLexer.GetLexedPaths();
+        for (const auto& [lPath, lBinary] : lInterpreter.GetBinaries())
+        {
+            lDependencies.insert(lPath);
+        }
+
+        lCache.Store(pInputFile, lOptions, lDependencies, lArtifacts);
+    }
+
+    lStats.End("emit", lWriter.GetImageSize(), "bytes");
+    lStats.Report();
+
+    return 0;
+}
+
+tmc::Int32 RunAssembler ()
+{
+    const tmc::Index lInputCount = tmc::Arguments::Count("input-file", 'i');
+    const tmc::Index lOutputCount = tmc::Arguments::Count("output-file", 'o');
+
+    if (lInputCount == 0 || tmc::Arguments::Get("input-file", 'i').empty() == true)
     {
         std::cerr << "[RunAssembler] Missing parameter: --input-file, -i." << std::endl;
         return 1;
     }
 
-    if (lLexer.TokenizeFile(lInputFile) == false)
+    if (lOutputCount != 0 && lOutputCount != lInputCount)
     {
-        return 2;
+        std::cerr << "[RunAssembler] Expected one output file per input file." << std::endl;
+        return 1;
     }
 
-    if (lLexOnly == true)
+    if (lInputCount > 1 && (tmc::Arguments::Get("map", 'm').empty() == false ||
+        tmc::Arguments::Get("line-table", 'g').empty() == false ||
+        tmc::Arguments::Get("code-map", 'k').empty() == false))
     {
-        lLexer.ListTokens();
-        return 0;
+        std::cerr << "[RunAssembler] Map, line table and code map paths cannot be given with multiple input files." << std::endl;
+        return 1;
     }
 
-    tmm::Program::Ptr lProgram = lParser.ParseProgram(lLexer);
-    if (lProgram == nullptr)
+    // Listing tokens writes to standard output, so it is never done in parallel.
+    tmc::Index lJobs = std::max<tmc::Index>(std::thread::hardware_concurrency(), 1);
+    if (tmc::Arguments::Has("jobs", 'j') == true)
     {
-        return 4;
+        lJobs = std::strtoull(tmc::Arguments::Get("jobs", 'j', "1").c_str(), nullptr, 10);
     }
 
-    if (lInterpreter.Run(lProgram) == false)
+    if (tmc::Arguments::Has("lex-only", 'l') == true)
     {
-        return 5;
+        lJobs = 1;
+    }
+
+    // Threads not needed to take a file each are shared out for linking.
+    const tmc::Index lLinkJobs = std::max<tmc::Index>(lJobs / lInputCount, 1);
+    lJobs = std::clamp<tmc::Index>(lJobs, 1, lInputCount);
+
+    // Each worker keeps its own lexer and parser, reused for every file it takes from the queue.
+    tmc::List<tmc::Int32>       lResults(lInputCount, 0);
+    std::atomic<tmc::Index>     lNextInput { 0 };
+
+    auto lWorker = [&] ()
+    {
+        tmm::Lexer  lLexer;
+        tmm::Parser lParser;
+
+        for (tmc::Index lIndex = lNextInput++; lIndex < lInputCount; lIndex = lNextInput++)
+        {
+            const tmc::String& lInputFile = tmc::Arguments::Get("input-file", 'i', lIndex);
+
+            lLexer.Reset();
+            lResults[lIndex] = AssembleFile(lLexer, lParser, lInputFile,
+                tmc::Arguments::Get("output-file", 'o', lIndex), lLinkJobs);
+
+            if (lResults[lIndex] != 0 && lInputCount > 1)
+            {
+                std::cerr << "[RunAssembler] Could not assemble '" << lInputFile << "'." << std::endl;
+            }
+        }
+    };
+
+    tmc::List<std::thread> lThreads;
+    for (tmc::Index lThread = 1; lThread < lJobs; ++lThread)
+    {
+        lThreads.emplace_back(lWorker);
+    }
+
+    lWorker();
+    for (std::thread& lThread : lThreads)
+    {
+        lThread.join();
+    }
+
+    // The result is that of the first input which failed, if any did.
+    for (const tmc::Int32& lResult : lResults)
+    {
+        if (lResult != 0)
+        {
+            return lResult;
+        }
     }
 
     return 0;
@@ -50,6 +325,12 @@ int main (int pArgCount, char** pArgVector)
     // Capture command-line arguments.
     tmc::Arguments::Capture(pArgCount, pArgVector);
     
+    if (tmc::Arguments::Has("serve", 's') == true)
+    {
+        tmm::Server lServer { tmc::Arguments::Get("serve", 's', "tmm.sock"), RunAssembler };
+        return (lServer.Run() == true) ? 0 : 1;
+    }
+
     if (tmc::Arguments::Has("assemble", 'a') == true)
     {
         return RunAssembler();
@@ -0,0 +1,263 @@
+/// @file TMM.Merger.cpp
+
+#include <TMM.Precompiled.hpp>
+#include <TMM.Merger.hpp>
+
+namespace tmm
+{
+
+    /* Static Constants ***************************************************************************/
+
+    // Every suffix of data up to this size is indexed, so that shorter data may be merged into
+    // its tail. Larger data is only indexed whole, which keeps the index linear in practice.
+    static constexpr tmc::Index MAX_SUFFIX_LENGTH = 256;
+
+    /* Static Functions ***************************************************************************/
+
+    static std::string_view GetBytes (const Fragment& pFragment)
+    {
+        return { reinterpret_cast<const tmc::Char*>(pFragment.mBytes.data()), pFragment.mBytes.size() };
+    }
+
+    static Fragment MakePiece (const Fragment& pHost, const tmc::Index& pBegin, const tmc::Index& pEnd)
+    {
+        Fragment lPiece;
+        lPiece.mType    = FragmentType::Data;
+        lPiece.mBytes.assign(pHost.mBytes.begin() + pBegin, pHost.mBytes.begin() + pEnd);
+        lPiece.mFile    = pHost.mFile;
+        lPiece.mLine    = pHost.mLine;
+
+        return lPiece;
+    }
+
+    static tmc::Boolean IsTerminated (const Fragment& pFragment)
+    {
+        return pFragment.mType == FragmentType::Data && pFragment.mFixups.empty() == true &&
+            pFragment.mBytes.empty() == false && pFragment.mBytes.back() == 0;
+    }
+
+    /* Public Constructors and Destructor *********************************************************/
+
+    Merger::Merger (Object& pObject) :
+        mObject { pObject }
+    {
+
+    }
+
+    /* Public Methods *****************************************************************************/
+
+    tmc::Index Merger::Run ()
+    {
+        CollectItems();
+        PlanMerges();
+        return Rebuild();
+    }
+
+    /* Private Methods ****************************************************************************/
+
+    void Merger::CollectItems ()
+    {
+        mItems.clear();
+
+        // Only data whose bytes are final - no fixups left to patch - can be shared. Data may
+        // only be moved if it is named by labels, and if nothing reads on into it or out of it:
+        // past its labels, it must meet code or the edge of the section on either side, or data
+        // ended by a zero terminator, as the strings of a message table are. A table spanning
+        // several statements, or whose labels may be addressed past each other, stays in one
+        // piece where it is.
+        for (tmc::Int32 lType = 0; lType < SectionType::ST_COUNT; ++lType)
+        {
+            Section& lSection = mObject.GetSection(lType);
+            if (lType == SectionType::ST_METADATA || lSection.IsRAM() == true)
+            {
+                continue;
+            }
+
+            const auto& lFragments = lSection.mFragments;
+            for (tmc::Index lIndex = 0; lIndex < lFragments.size(); ++lIndex)
+            {
+                const Fragment& lFragment = lFragments[lIndex];
+                if (lFragment.mType != FragmentType::Data || lFragment.mFixups.empty() == false ||
+                    lFragment.mBytes.empty() == true)
+                {
+                    continue;
+                }
+
+                tmc::Index lLabels = lIndex;
+                while (lLabels > 0 && lFragments[lLabels - 1].mType == FragmentType::Label)
+                {
+                    --lLabels;
+                }
+
+                tmc::Index lNext = lIndex + 1;
+                while (lNext < lFragments.size() && lFragments[lNext].mType == FragmentType::Label)
+                {
+                    ++lNext;
+                }
+
+                const tmc::Boolean lSelfContained =
+                    (lLabels == 0 || lFragments[lLabels - 1].mType == FragmentType::Code ||
+                        IsTerminated(lFragments[lLabels - 1]) == true) &&
+                    (lNext == lFragments.size() || lFragments[lNext].mType == FragmentType::Code ||
+                        (lNext > lIndex + 1 && IsTerminated(lFragment) == true));
+
+                Item lItem;
+                lItem.mSection      = &lSection;
+                lItem.mFragment     = lIndex;
+                lItem.mLabels       = lLabels;
+                lItem.mMergeable    = (lLabels < lIndex && lSelfContained == true);
+                mItems.push_back(lItem);
+            }
+        }
+    }
+
+    void Merger::PlanMerges ()
+    {
+        // Data is visited longest first, so that anything it could be merged into has already
+        // been indexed. Among equal data, the first to appear is kept.
+        tmc::List<tmc::Index> lOrder(mItems.size());
+        for (tmc::Index lIndex = 0; lIndex < lOrder.size(); ++lIndex)
+        {
+            lOrder[lIndex] = lIndex;
+        }
+
+        auto lSizeOf = [&] (const tmc::Index& pItem)
+        {
+            return mItems[pItem].mSection->mFragments[mItems[pItem].mFragment].mBytes.size();
+        };
+
+        std::stable_sort(lOrder.begin(), lOrder.end(), [&] (const tmc::Index& pLeft, const tmc::Index& pRight)
+        {
+            return lSizeOf(pLeft) > lSizeOf(pRight);
+        });
+
+        // Each suffix of the kept data maps to the data and the offset it starts at.
+        tmc::Map<std::string_view, std::pair<tmc::Index, tmc::Index>> lSuffixes;
+        lSuffixes.reserve(mItems.size() * 4);
+
+        for (const tmc::Index& lIndex : lOrder)
+        {
+            Item& lItem = mItems[lIndex];
+            const std::string_view lBytes = GetBytes(lItem.mSection->mFragments[lItem.mFragment]);
+
+            if (lItem.mMergeable == true)
+            {
+                auto lIter = lSuffixes.find(lBytes);
+                if (lIter != lSuffixes.end())
+                {
+                    lItem.mHost     = lIter->second.first;
+                    lItem.mOffset   = lIter->second.second;
+                    continue;
+                }
+            }
+
+            const tmc::Index lCount = (lBytes.size() <= MAX_SUFFIX_LENGTH) ? lBytes.size() : 1;
+            for (tmc::Index lOffset = 0; lOffset < lCount; ++lOffset)
+            {
+                lSuffixes.try_emplace(lBytes.substr(lOffset), lIndex, lOffset);
+            }
+        }
+    }
+
+    tmc::Index Merger::Rebuild ()
+    {
+        tmc::Index lSaved = 0;
+
+        // Find, for each kept data, the merged data whose labels now point into it, in order of
+        // offset; and mark the merged data, and the labels naming it, for removal.
+        tmc::List<tmc::List<tmc::Index>>                        lInserts(mItems.size());
+        tmc::Array<tmc::List<tmc::Boolean>, SectionType::ST_COUNT> lRemoved;
+        tmc::Array<tmc::List<tmc::Index>, SectionType::ST_COUNT>   lItemAt;
+
+        for (tmc::Int32 lType = 0; lType < SectionType::ST_COUNT; ++lType)
+        {
+            const tmc::Index lCount = mObject.GetSection(lType).mFragments.size();
+            lRemoved[lType].assign(lCount, false);
+            lItemAt[lType].assign(lCount, tmc::NPOS);
+        }
+
+        for (tmc::Index lIndex = 0; lIndex < mItems.size(); ++lIndex)
+        {
+            const Item& lItem = mItems[lIndex];
+            lItemAt[lItem.mSection->mType][lItem.mFragment] = lIndex;
+
+            if (lItem.mHost == tmc::NPOS)
+            {
+                continue;
+            }
+
+            lInserts[lItem.mHost].push_back(lIndex);
+            lSaved += lItem.mSection->mFragments[lItem.mFragment].mBytes.size();
+
+            for (tmc::Index lFragment = lItem.mLabels; lFragment <= lItem.mFragment; ++lFragment)
+            {
+                lRemoved[lItem.mSection->mType][lFragment] = true;
+            }
+        }
+
+        if (lSaved == 0)
+        {
+            return 0;
+        }
+
+        // Kept data is split wherever labels now point into it. Labels may move between
+        // sections, so every section is rebuilt before any is replaced.
+        tmc::Array<tmc::List<Fragment>, SectionType::ST_COUNT> lRebuilt;
+        for (tmc::Int32 lType = 0; lType < SectionType::ST_COUNT; ++lType)
+        {
+            auto& lFragments = mObject.GetSection(lType).mFragments;
+            auto& lTarget = lRebuilt[lType];
+            lTarget.reserve(lFragments.size());
+
+            for (tmc::Index lIndex = 0; lIndex < lFragments.size(); ++lIndex)
+            {
+                if (lRemoved[lType][lIndex] == true)
+                {
+                    continue;
+                }
+
+                const tmc::Index lItem = lItemAt[lType][lIndex];
+                if (lItem == tmc::NPOS || lInserts[lItem].empty() == true)
+                {
+                    lTarget.push_back(std::move(lFragments[lIndex]));
+                    continue;
+                }
+
+                auto& lMerged = lInserts[lItem];
+                std::stable_sort(lMerged.begin(), lMerged.end(), [&] (const tmc::Index& pLeft, const tmc::Index& pRight)
+                {
+                    return mItems[pLeft].mOffset < mItems[pRight].mOffset;
+                });
+
+                const Fragment& lHost = lFragments[lIndex];
+                tmc::Index lPosition = 0;
+
+                for (const tmc::Index& lMergedIndex : lMerged)
+                {
+                    const Item& lMergedItem = mItems[lMergedIndex];
+                    if (lMergedItem.mOffset > lPosition)
+                    {
+                        lTarget.push_back(MakePiece(lHost, lPosition, lMergedItem.mOffset));
+                        lPosition = lMergedItem.mOffset;
+                    }
+
+                    auto& lSource = lMergedItem.mSection->mFragments;
+                    for (tmc::Index lLabel = lMergedItem.mLabels; lLabel < lMergedItem.mFragment; ++lLabel)
+                    {
+                        lTarget.push_back(std::move(lSource[lLabel]));
+                    }
+                }
+
+                lTarget.push_back(MakePiece(lHost, lPosition, lHost.mBytes.size()));
+            }
+        }
+
+        for (tmc::Int32 lType = 0; lType < SectionType::ST_COUNT; ++lType)
+        {
+            mObject.GetSection(lType).mFragments = std::move(lRebuilt[lType]);
+        }
+
+        return lSaved;
+    }
+
+}
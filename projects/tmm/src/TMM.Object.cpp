@@ -2,10 +2,234 @@
 
 #include <TMM.Precompiled.hpp>
 #include <TMM.Object.hpp>
+#include <TMM.Placement.hpp>
 
 namespace tmm
 {
 
-    
+    /* Public Methods - Fragment ******************************************************************/
+
+    tmc::Word Fragment::GetOpcode () const
+    {
+        if (mType != FragmentType::Code || mBytes.size() < 2)
+        {
+            return 0;
+        }
+
+        return static_cast<tmc::Word>(mBytes[0] | (mBytes[1] << 8));
+    }
+
+    tmc::Index Fragment::GetSize () const
+    {
+        switch (mType)
+        {
+            case FragmentType::Label:   return 0;
+            case FragmentType::Space:
+            case FragmentType::Binary:  return mSpace;
+            default:                    return mBytes.size();
+        }
+    }
+
+    const tmc::Byte* Fragment::GetData () const
+    {
+        switch (mType)
+        {
+            case FragmentType::Label:
+            case FragmentType::Space:   return nullptr;
+            case FragmentType::Binary:  return mBinary->GetData() + mBinaryOffset;
+            default:                    return mBytes.data();
+        }
+    }
+
+    void Fragment::Patch (const tmc::Index& pOffset, const tmc::Index& pSize,
+        const tmc::Int64& pValue)
+    {
+        // All values are stored little-endian.
+        for (tmc::Index lIndex = 0; lIndex < pSize; ++lIndex)
+        {
+            mBytes.at(pOffset + lIndex) = static_cast<tmc::Byte>((pValue >> (lIndex * 8)) & 0xFF);
+        }
+    }
+
+    /* Public Methods - Section *******************************************************************/
+
+    tmc::Boolean Section::IsEmpty () const
+    {
+        return mSize == 0;
+    }
+
+    tmc::Boolean Section::IsRAM () const
+    {
+        return mType >= SectionType::ST_RAM;
+    }
+
+    tmc::String Section::GetName () const
+    {
+        static constexpr const tmc::Char* HEX_DIGITS = "0123456789ABCDEF";
+
+        switch (mType)
+        {
+            case SectionType::ST_METADATA:  return "METADATA";
+            case SectionType::ST_PROGRAM:   return "PROGRAM";
+            case SectionType::ST_RAM:       return "RAM";
+            case SectionType::ST_QRAM:      return "QRAM";
+            default:
+                return (mType <= SectionType::ST_RST_F) ?
+                    tmc::String { "RST" } + HEX_DIGITS[mType - SectionType::ST_RST_0] :
+                    tmc::String { "INT" } + HEX_DIGITS[mType - SectionType::ST_INT_0];
+        }
+    }
+
+    /* Public Constructors and Destructor *********************************************************/
+
+    Object::Object ()
+    {
+        for (tmc::Int32 lType = 0; lType < SectionType::ST_COUNT; ++lType)
+        {
+            Section& lSection = mSections[lType];
+            lSection.mType = lType;
+
+            if (lType == SectionType::ST_METADATA)
+            {
+                // The 'METADATA' section holds any metadata beyond what the specification
+                // requires; the required fields are written along with the image.
+                lSection.mStart = tmc::PROGRAM_EXTRA_METADATA_START;
+                lSection.mEnd   = tmc::PROGRAM_METADATA_END;
+            }
+            else if (lType <= SectionType::ST_RST_F)
+            {
+                lSection.mStart = tmc::RESTART_VECTOR_START + ((lType - SectionType::ST_RST_0) << 8);
+                lSection.mEnd   = lSection.mStart + 0xFF;
+            }
+            else if (lType <= SectionType::ST_INT_F)
+            {
+                lSection.mStart = tmc::INTERRUPT_VECTOR_START + ((lType - SectionType::ST_INT_0) << 8);
+                lSection.mEnd   = lSection.mStart + 0xFF;
+            }
+            else if (lType == SectionType::ST_PROGRAM)
+            {
+                lSection.mStart = tmc::PROGRAM_START;
+                lSection.mEnd   = tmc::PROGRAM_END;
+            }
+            else if (lType == SectionType::ST_RAM)
+            {
+                lSection.mStart = tmc::RAM_START;
+                lSection.mEnd   = tmc::STACK_START - 1;
+            }
+            else
+            {
+                lSection.mStart = tmc::QRAM_START;
+                lSection.mEnd   = tmc::IO_START - 1;
+            }
+
+            // RAM sections only reserve space, which is only ever found through its labels, so
+            // they may go wherever their region has room.
+            lSection.mFloating = lSection.IsRAM();
+        }
+    }
+
+    /* Public Methods *****************************************************************************/
+
+    Section& Object::GetSection (const tmc::Int32& pSectionType)
+    {
+        return mSections.at(pSectionType);
+    }
+
+    const Section& Object::GetSection (const tmc::Int32& pSectionType) const
+    {
+        return mSections.at(pSectionType);
+    }
+
+    tmc::Index Object::InternFile (const tmc::Path& pPath)
+    {
+        auto [lIter, lInserted] = mFileIndices.try_emplace(pPath.string(), mFiles.size());
+        if (lInserted == true)
+        {
+            mFiles.push_back(pPath);
+        }
+
+        return lIter->second;
+    }
+
+    tmc::Boolean Object::Layout ()
+    {
+        // The required metadata and the memory the processor itself uses are never given to a
+        // section.
+        Placement lPlacement;
+        lPlacement.Reserve(tmc::PROGRAM_METADATA_START,
+            tmc::PROGRAM_EXTRA_METADATA_START - tmc::PROGRAM_METADATA_START, "required metadata");
+        lPlacement.Reserve(tmc::STACK_START, tmc::STACK_END - tmc::STACK_START + 1ULL, "stack");
+        lPlacement.Reserve(tmc::CALL_STACK_START, tmc::CALL_STACK_END - tmc::CALL_STACK_START + 1ULL,
+            "call stack");
+        lPlacement.Reserve(tmc::IO_START, tmc::IO_END - tmc::IO_START + 1ULL, "I/O registers");
+
+        for (Section& lSection : mSections)
+        {
+            lSection.mSize = 0;
+            for (const Fragment& lFragment : lSection.mFragments)
+            {
+                lSection.mSize += lFragment.GetSize();
+            }
+        }
+
+        // Fixed sections are placed first, at the start of their regions, and then floating
+        // sections are fitted into what is left.
+        for (tmc::Boolean lFloating : { false, true })
+        {
+            for (Section& lSection : mSections)
+            {
+                if (lSection.mFloating != lFloating) { continue; }
+
+                if (lSection.mSize > static_cast<tmc::Index>(lSection.mEnd - lSection.mStart) + 1)
+                {
+                    std::cerr   << "[Object] Section '" << lSection.GetName() << "' is " << lSection.mSize
+                                << " bytes, which overflows its region ending at $" << std::hex
+                                << lSection.mEnd << std::dec << "." << std::endl;
+                    return false;
+                }
+
+                tmc::Uint64 lStart = lSection.mStart;
+                if (lFloating == true)
+                {
+                    if (lPlacement.Place(lSection.mSize, lSection.mStart, lSection.mEnd,
+                        lSection.GetName(), lStart) == false)
+                    {
+                        return false;
+                    }
+
+                    lSection.mStart = static_cast<tmc::Address>(lStart);
+                }
+                else if (lPlacement.Reserve(lStart, lSection.mSize, lSection.GetName()) == false)
+                {
+                    return false;
+                }
+
+                tmc::Index lOffset = 0;
+                for (Fragment& lFragment : lSection.mFragments)
+                {
+                    lFragment.mAddress = static_cast<tmc::Address>(lSection.mStart + lOffset);
+                    lOffset += lFragment.GetSize();
+                }
+            }
+        }
+
+        return true;
+    }
+
+    tmc::Index Object::GetSize () const
+    {
+        // Counted from the fragments, so that this is also correct before the object is laid out.
+        tmc::Index lSize = 0;
+        for (const Section& lSection : mSections)
+        {
+            if (lSection.IsRAM() == true) { continue; }
+            for (const Fragment& lFragment : lSection.mFragments)
+            {
+                lSize += lFragment.GetSize();
+            }
+        }
+
+        return lSize;
+    }
 
 }
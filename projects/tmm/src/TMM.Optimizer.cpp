@@ -0,0 +1,405 @@
+/// @file TMM.Optimizer.cpp
+
+#include <TMM.Precompiled.hpp>
+#include <TMM.Optimizer.hpp>
+
+namespace tmm
+{
+
+    /* Static Constants - Flag Masks **************************************************************/
+
+    static constexpr tmc::Uint8 FLAG_Z      = 0b10000000;
+    static constexpr tmc::Uint8 FLAG_N      = 0b01000000;
+    static constexpr tmc::Uint8 FLAG_H      = 0b00100000;
+    static constexpr tmc::Uint8 FLAG_C      = 0b00010000;
+    static constexpr tmc::Uint8 FLAG_O      = 0b00001000;
+    static constexpr tmc::Uint8 FLAG_U      = 0b00000100;
+    static constexpr tmc::Uint8 FLAGS_ALL   = FLAG_Z | FLAG_N | FLAG_H | FLAG_C | FLAG_O | FLAG_U;
+
+    /* Static Functions ***************************************************************************/
+
+    static tmc::Uint8 GetConditionFlag (const tmc::Uint8& pCondition)
+    {
+        switch (pCondition)
+        {
+            case ConditionType::CT_CS:
+            case ConditionType::CT_CC:  return FLAG_C;
+            case ConditionType::CT_ZS:
+            case ConditionType::CT_ZC:  return FLAG_Z;
+            case ConditionType::CT_OS:  return FLAG_O;
+            case ConditionType::CT_US:  return FLAG_U;
+            default:                    return 0;
+        }
+    }
+
+    static void GetFlagEffects (const tmc::Word& pOpcode, tmc::Uint8& pUse, tmc::Uint8& pDef)
+    {
+        // The flags read ('pUse') and written ('pDef') by each instruction, as listed in the
+        // instruction flags table of the TM specification. Only 'Z', 'N', 'H', 'C', 'O' and 'U'
+        // are tracked; the halt and stop flags are never read by conditions.
+        const tmc::Uint8 lInstruction = static_cast<tmc::Uint8>(pOpcode >> 8);
+        const tmc::Uint8 lX = static_cast<tmc::Uint8>((pOpcode >> 4) & 0xF);
+
+        pUse = 0;
+        pDef = 0;
+
+        switch (lInstruction)
+        {
+            case 0x07:  pUse = FLAG_N | FLAG_H | FLAG_C;
+                        pDef = FLAG_Z | FLAG_H | FLAG_C | FLAG_O | FLAG_U; break;   // DAL, DAW, DAB
+            case 0x08:  pDef = FLAG_N | FLAG_H; break;                              // CPL, CPW, CPB
+            case 0x09:  pDef = FLAG_N | FLAG_H | FLAG_C | FLAG_O | FLAG_U; break;   // SCF
+            case 0x0A:  pUse = FLAG_C;
+                        pDef = FLAG_N | FLAG_H | FLAG_C | FLAG_O | FLAG_U; break;   // CCF
+            case 0x20:
+            case 0x21:
+            case 0x22:
+            case 0x25:  pUse = GetConditionFlag(lX); break;                         // JMP, JPB, RET
+            case 0x23:
+            case 0x24:  pUse = FLAGS_ALL; break;                                    // CALL, RST
+            case 0x37: case 0x38: case 0x39:                                        // ADC
+            case 0x3D: case 0x3E: case 0x3F:                                        // SBC
+            case 0x56: case 0x57:                                                   // RL
+            case 0x5A: case 0x5B:                                                   // RR
+                        pUse = FLAG_C; pDef = FLAGS_ALL; break;
+            case 0x60:
+            case 0x61:  pDef = FLAG_Z | FLAG_N | FLAG_H; break;                     // BIT
+            case 0x62:
+            case 0x63:  pDef = FLAG_N | FLAG_H | FLAG_C; break;                     // SET
+            default:
+                if ((lInstruction >= 0x30 && lInstruction <= 0x5D) ||
+                    lInstruction == 0x66 || lInstruction == 0x67)
+                {
+                    pDef = FLAGS_ALL;                                               // Arithmetic, etc.
+                }
+                else if (lInstruction > 0x67 && lInstruction != 0xFF)
+                {
+                    pUse = FLAGS_ALL;                                               // Unknown opcode.
+                }
+                break;
+        }
+    }
+
+    static tmc::Boolean EndsBlock (const tmc::Word& pOpcode)
+    {
+        switch (pOpcode >> 8)
+        {
+            case 0x20:  // JMP X, [A32]
+            case 0x21:  // JMP X, [Y]
+            case 0x22:  // JPB X, S16
+            case 0x25:  // RET X
+            case 0x26:  // RETI
+            case 0xFF:  // JPS
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    static void RemoveMarked (Section& pSection, const tmc::List<tmc::Boolean>& pMarked)
+    {
+        tmc::Index lTarget = 0;
+        for (tmc::Index lIndex = 0; lIndex < pSection.mFragments.size(); ++lIndex)
+        {
+            if (pMarked[lIndex] == false)
+            {
+                if (lTarget != lIndex)
+                {
+                    pSection.mFragments[lTarget] = std::move(pSection.mFragments[lIndex]);
+                }
+
+                ++lTarget;
+            }
+        }
+
+        pSection.mFragments.resize(lTarget);
+    }
+
+    /* Public Constructors and Destructor *********************************************************/
+
+    Optimizer::Optimizer (Object& pObject) :
+        mObject { pObject }
+    {
+
+    }
+
+    /* Public Methods *****************************************************************************/
+
+    tmc::Index Optimizer::Run ()
+    {
+        tmc::Index lCount = 0;
+        for (tmc::Int32 lType = 0; lType < SectionType::ST_COUNT; ++lType)
+        {
+            Section& lSection = mObject.GetSection(lType);
+            if (lSection.IsRAM() == false)
+            {
+                lCount += OptimizeSection(lSection);
+            }
+        }
+
+        return lCount;
+    }
+
+    /* Private Methods ****************************************************************************/
+
+    tmc::Index Optimizer::OptimizeSection (Section& pSection)
+    {
+        // Removing one instruction can expose another rewrite, so repeat until nothing changes.
+        tmc::Index lTotal = 0;
+        tmc::Index lCount = 0;
+
+        do
+        {
+            lCount  = RewritePairs(pSection);
+            lCount += RewriteDeadFlags(pSection);
+            lTotal += lCount;
+        } while (lCount > 0);
+
+        return lTotal;
+    }
+
+    tmc::Index Optimizer::RewritePairs (Section& pSection)
+    {
+        auto& lFragments = pSection.mFragments;
+        tmc::List<tmc::Boolean> lMarked(lFragments.size(), false);
+        tmc::Index lCount = 0;
+
+        for (tmc::Index lIndex = 0; lIndex < lFragments.size(); ++lIndex)
+        {
+            const Fragment& lFragment = lFragments[lIndex];
+            if (lFragment.mType != FragmentType::Code) { continue; }
+
+            const tmc::Word lOpcode = lFragment.GetOpcode();
+
+            // 'MV X, X' does nothing.
+            if ((lOpcode >> 8) == 0x19 && ((lOpcode >> 4) & 0xF) == (lOpcode & 0xF))
+            {
+                lMarked[lIndex] = true;
+                ++lCount;
+            }
+
+            // 'PUSH X' immediately followed by 'POP X' does nothing. A label in between would be
+            // its own fragment, so the pair is only matched when nothing can jump to the 'POP'.
+            else if ((lOpcode >> 8) == 0x1A && lIndex + 1 < lFragments.size() &&
+                lFragments[lIndex + 1].mType == FragmentType::Code)
+            {
+                const tmc::Word lNext = lFragments[lIndex + 1].GetOpcode();
+                if ((lNext >> 8) == 0x1B && ((lNext >> 4) & 0xF) == (lOpcode & 0xF))
+                {
+                    lMarked[lIndex] = lMarked[lIndex + 1] = true;
+                    lCount += 2;
+                    ++lIndex;
+                }
+            }
+        }
+
+        if (lCount > 0)
+        {
+            RemoveMarked(pSection, lMarked);
+        }
+
+        return lCount;
+    }
+
+    tmc::Index Optimizer::RewriteDeadFlags (Section& pSection)
+    {
+        BuildBlocks(pSection);
+        SolveLiveness(pSection);
+
+        auto& lFragments = pSection.mFragments;
+        tmc::List<tmc::Boolean> lMarked(lFragments.size(), false);
+        tmc::Index lCount = 0;
+
+        for (const Block& lBlock : mBlocks)
+        {
+            tmc::Uint8 lLive = lBlock.mLiveOut;
+
+            for (tmc::Index lIndex = lBlock.mEnd; lIndex-- > lBlock.mBegin; )
+            {
+                Fragment& lFragment = lFragments[lIndex];
+                if (lFragment.mType != FragmentType::Code) { continue; }
+
+                const tmc::Word  lOpcode = lFragment.GetOpcode();
+                const tmc::Uint8 lInstruction = static_cast<tmc::Uint8>(lOpcode >> 8);
+                const tmc::Uint8 lX = static_cast<tmc::Uint8>((lOpcode >> 4) & 0xF);
+
+                // 'CMP X, I' and 'CMP X, Y' only write flags, so they can go if none of them are
+                // read. 'CMP X, [Y]' is kept, since the read could reach a hardware register.
+                if ((lInstruction == 0x49 || lInstruction == 0x4A) && (lLive & FLAGS_ALL) == 0)
+                {
+                    lMarked[lIndex] = true;
+                    ++lCount;
+                    continue;
+                }
+
+                // 'LD X, 0' becomes the shorter 'XOR X, X' if the flags it writes are not read.
+                if (lInstruction == 0x10 && lFragment.mFixups.empty() == true &&
+                    (lLive & FLAGS_ALL) == 0 &&
+                    std::all_of(lFragment.mBytes.begin() + 2, lFragment.mBytes.end(),
+                        [] (const tmc::Byte& pByte) { return pByte == 0; }))
+                {
+                    lFragment.mBytes = { static_cast<tmc::Byte>((lX << 4) | lX), 0x47 };
+                    ++lCount;
+                }
+
+                tmc::Uint8 lUse = 0, lDef = 0;
+                GetFlagEffects(lFragment.GetOpcode(), lUse, lDef);
+                lLive = (lLive & ~lDef) | lUse;
+            }
+        }
+
+        if (lCount > 0)
+        {
+            RemoveMarked(pSection, lMarked);
+        }
+
+        return lCount;
+    }
+
+    void Optimizer::BuildBlocks (const Section& pSection)
+    {
+        const auto& lFragments = pSection.mFragments;
+        tmc::Dictionary<tmc::Index> lLabels;
+        tmc::Index lBegin = 0;
+
+        mBlocks.clear();
+
+        // Split the section into basic blocks. A block begins at a label and ends after an
+        // instruction which transfers control. Data fragments form blocks of their own.
+        for (tmc::Index lIndex = 0; lIndex < lFragments.size(); ++lIndex)
+        {
+            const Fragment& lFragment = lFragments[lIndex];
+            switch (lFragment.mType)
+            {
+                case FragmentType::Label:
+                    if (lIndex > lBegin)
+                    {
+                        mBlocks.push_back({ lBegin, lIndex });
+                        lBegin = lIndex;
+                    }
+
+                    lLabels[lFragment.mLabel] = mBlocks.size();
+                    break;
+                case FragmentType::Code:
+                    if (EndsBlock(lFragment.GetOpcode()) == true)
+                    {
+                        mBlocks.push_back({ lBegin, lIndex + 1 });
+                        lBegin = lIndex + 1;
+                    }
+                    break;
+                default:
+                    if (lIndex > lBegin)
+                    {
+                        mBlocks.push_back({ lBegin, lIndex });
+                    }
+
+                    mBlocks.push_back({ lIndex, lIndex + 1 });
+                    lBegin = lIndex + 1;
+                    break;
+            }
+        }
+
+        if (lBegin < lFragments.size())
+        {
+            mBlocks.push_back({ lBegin, lFragments.size() });
+        }
+
+        // Connect each block to its successors. Wherever control may leave for code this pass
+        // cannot see - an indirect jump, a return, data, or the end of the section - every flag
+        // is assumed to be read.
+        for (tmc::Index lIndex = 0; lIndex < mBlocks.size(); ++lIndex)
+        {
+            Block& lBlock = mBlocks[lIndex];
+            const Fragment& lLast = lFragments[lBlock.mEnd - 1];
+            tmc::Boolean lFallsThrough = true;
+
+            if (lLast.mType != FragmentType::Code && lLast.mType != FragmentType::Label)
+            {
+                lBlock.mExitLive = FLAGS_ALL;
+                continue;
+            }
+            else if (lLast.mType == FragmentType::Code && EndsBlock(lLast.GetOpcode()) == true)
+            {
+                const tmc::Word lOpcode = lLast.GetOpcode();
+                const tmc::Boolean lConditional = ((lOpcode >> 4) & 0xF) != ConditionType::CT_N;
+
+                lFallsThrough = false;
+                switch (lOpcode >> 8)
+                {
+                    case 0x20:
+                    case 0x22:
+                    {
+                        auto lTarget = lLabels.end();
+                        if (lLast.mFixups.empty() == false &&
+                            lLast.mFixups.front().mExpression->GetType() == SyntaxType::Identifier)
+                        {
+                            lTarget = lLabels.find(Expression::Cast<Identifier>(
+                                lLast.mFixups.front().mExpression)->GetSymbol());
+                        }
+
+                        if (lTarget != lLabels.end())   { lBlock.mSuccessors.push_back(lTarget->second); }
+                        else                            { lBlock.mExitLive = FLAGS_ALL; }
+
+                        lFallsThrough = lConditional;
+                    } break;
+                    case 0x21:
+                    case 0x25:
+                        lBlock.mExitLive = FLAGS_ALL;
+                        lFallsThrough = lConditional;
+                        break;
+                    default:
+                        lBlock.mExitLive = FLAGS_ALL;
+                        break;
+                }
+            }
+
+            if (lFallsThrough == true)
+            {
+                if (lIndex + 1 < mBlocks.size())    { lBlock.mSuccessors.push_back(lIndex + 1); }
+                else                                { lBlock.mExitLive = FLAGS_ALL; }
+            }
+        }
+    }
+
+    void Optimizer::SolveLiveness (const Section& pSection)
+    {
+        const auto& lFragments = pSection.mFragments;
+        tmc::Boolean lChanged = true;
+
+        // Backward data-flow: a flag is live on entry to a block if it is read before being
+        // written, or if it is live on exit and the block does not write it.
+        while (lChanged == true)
+        {
+            lChanged = false;
+
+            for (tmc::Index lIndex = mBlocks.size(); lIndex-- > 0; )
+            {
+                Block& lBlock = mBlocks[lIndex];
+                tmc::Uint8 lLive = lBlock.mExitLive;
+
+                for (const tmc::Index& lSuccessor : lBlock.mSuccessors)
+                {
+                    lLive |= mBlocks[lSuccessor].mLiveIn;
+                }
+
+                lBlock.mLiveOut = lLive;
+
+                for (tmc::Index lFragment = lBlock.mEnd; lFragment-- > lBlock.mBegin; )
+                {
+                    if (lFragments[lFragment].mType != FragmentType::Code) { continue; }
+
+                    tmc::Uint8 lUse = 0, lDef = 0;
+                    GetFlagEffects(lFragments[lFragment].GetOpcode(), lUse, lDef);
+                    lLive = (lLive & ~lDef) | lUse;
+                }
+
+                if (lLive != lBlock.mLiveIn)
+                {
+                    lBlock.mLiveIn = lLive;
+                    lChanged = true;
+                }
+            }
+        }
+    }
+
+}
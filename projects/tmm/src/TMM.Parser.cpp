@@ -11,27 +11,61 @@ namespace tmm
     Program::Ptr Parser::ParseProgram (Lexer& pLexer)
     {
         Program::Ptr lProgram = Statement::Make<Program>();
+        Reset();
 
         while (pLexer.HasMoreTokens() == true)
         {
-            Token lLeadToken = pLexer.TokenAt();
-            Statement::Ptr lStatement = ParseStatement(pLexer);
-
-            if (lStatement != nullptr)
+            Statement::Ptr lStatement = ParseNextStatement(pLexer);
+            if (lStatement == nullptr)
             {
-                lProgram->Push(lStatement);
-            }
-            else
-            {
-                std::cerr   << "[Parser]   In file '" << lLeadToken.mFile.string() << ":"
-                            << lLeadToken.mLine << "'." << std::endl;
                 return nullptr;
             }
+
+            lProgram->Push(lStatement);
         }
 
         return lProgram;
     }
 
+    Statement::Ptr Parser::ParseNextStatement (Lexer& pLexer)
+    {
+        // The tokens of earlier statements are no longer needed.
+        pLexer.ReleaseTokens();
+
+        Token lLeadToken = pLexer.TokenAt();
+        Statement::Ptr lStatement = ParseStatement(pLexer);
+
+        if (lStatement == nullptr)
+        {
+            std::cerr   << "[Parser]   In file '" << lLeadToken.mFile.string() << ":"
+                        << lLeadToken.mLine << "'." << std::endl;
+            return nullptr;
+        }
+
+        lStatement->SetLocation(InternFile(lLeadToken.mFile), lLeadToken.mLine);
+        return lStatement;
+    }
+
+    void Parser::Reset ()
+    {
+        mMacros.clear();
+    }
+
+    /* Private Methods ****************************************************************************/
+
+    tmc::Index Parser::InternFile (const tmc::Path& pPath)
+    {
+        // Statements mostly follow others from the same file, so the shared table is only
+        // consulted when the file changes.
+        if (mFileIndex == tmc::NPOS || pPath != mFilePath)
+        {
+            mFilePath = pPath;
+            mFileIndex = Statement::InternFile(pPath);
+        }
+
+        return mFileIndex;
+    }
+
     /* Private Methods - Parse Statements *********************************************************/
 
     Statement::Ptr Parser::ParseStatement (Lexer& pLexer)
@@ -39,15 +73,17 @@ namespace tmm
         const auto& lToken      = pLexer.TokenAt();
         const auto& lKeyword    = lToken.GetKeyword();
 
-        if (lKeyword.mType == KeywordType::Language)
+        if (lToken.GetDirective().mType == KeywordType::Language)
+        {
+            return ParseData(pLexer);
+        }
+        else if (lKeyword.mType == KeywordType::Language)
         {
             switch (lKeyword.mParamOne)
             {
                 case LanguageType::LT_SECTION:      return ParseSection(pLexer);
-                case LanguageType::LT_DB:
-                case LanguageType::LT_DW:
-                case LanguageType::LT_DL:
-                case LanguageType::LT_DS:           return ParseData(pLexer);
+                case LanguageType::LT_MACRO:        return ParseMacro(pLexer);
+                case LanguageType::LT_INCBIN:       return ParseIncbin(pLexer);
                 default:
                     std::cerr << "[Parser] Un-implemented language keyword: '" << lToken.mValue << "'." << std::endl;
                     return nullptr;
@@ -61,6 +97,10 @@ namespace tmm
         {
             return ParseLabel(pLexer);
         }
+        else if (lToken.mType == TokenType::Identifier && mMacros.contains(lToken.mValue) == true)
+        {
+            return ParseMacroCall(pLexer);
+        }
 
         return ParseExpression(pLexer);
     }
@@ -101,17 +141,36 @@ namespace tmm
     Statement::Ptr Parser::ParseData (Lexer& pLexer)
     {
         // Discard the leading token, but keep track of its keyword.
-        const Keyword& lDataKeyword = pLexer.DiscardToken().GetKeyword();
+        const Keyword& lDataKeyword = pLexer.DiscardToken().GetDirective();
 
         // Create the data statement now.
         DataStatement::Ptr lStatement = Statement::Make<DataStatement>(lDataKeyword.mParamOne);
 
-        // Loop, parsing expressions along the way.
+        tmc::Index lSize = 1;
+        switch (lDataKeyword.mParamOne)
+        {
+            case LanguageType::LT_DW:   lSize = 2; break;
+            case LanguageType::LT_DL:   lSize = 4; break;
+            default:                    break;
+        }
+
+        // Loop, parsing expressions along the way. Lone literals are packed into the statement
+        // as they are found, so large tables do not become one syntax node per element.
         while (true)
         {
-            Expression::Ptr lExpression = ParseExpression(pLexer);
-            if (lExpression == nullptr)     { return nullptr; }
-            else                            { lStatement->PushExpression(lExpression); }
+            tmc::Boolean lPacked = false;
+            if (lDataKeyword.mParamOne != LanguageType::LT_DS &&
+                PackDataLiteral(pLexer, *lStatement, lSize, lPacked) == false)
+            {
+                return nullptr;
+            }
+
+            if (lPacked == false)
+            {
+                Expression::Ptr lExpression = ParseExpression(pLexer);
+                if (lExpression == nullptr)     { return nullptr; }
+                else                            { lStatement->PushExpression(lExpression); }
+            }
 
             // Continue parsing expressions for this data statement until a separating comma is
             // not encountered.
@@ -124,6 +183,123 @@ namespace tmm
         return lStatement;
     }
 
+    tmc::Boolean Parser::PackDataLiteral (Lexer& pLexer, DataStatement& pStatement,
+        const tmc::Index& pSize, tmc::Boolean& pPacked)
+    {
+        // Only a literal (optionally negated) which makes up a whole element can be packed.
+        const tmc::Boolean  lNegative   = pLexer.TokenAt().mType == TokenType::Minus;
+        const Token&        lToken      = pLexer.TokenAt(lNegative ? 1 : 0);
+
+        pPacked = false;
+        switch (lToken.mType)
+        {
+            case TokenType::String:
+                if (lNegative == true) { return true; }
+                break;
+            case TokenType::Char:
+            case TokenType::Number:
+            case TokenType::Binary:
+            case TokenType::Octal:
+            case TokenType::Hexadecimal:
+                break;
+            default:
+                return true;
+        }
+
+        const Token& lNext = pLexer.TokenAt(lNegative ? 2 : 1);
+        if (lNext.IsOperator() == true || lNext.mType == TokenType::Concat ||
+            lNext.mType == TokenType::Exponent || lNext.mType == TokenType::Increment ||
+            lNext.mType == TokenType::Decrement)
+        {
+            return true;
+        }
+
+        pPacked = true;
+        if (lNegative == true)
+        {
+            pLexer.DiscardToken();
+        }
+
+        pLexer.DiscardToken();
+
+        // Strings are emitted one character per element; a string of bytes is copied whole.
+        if (lToken.mType == TokenType::String)
+        {
+            if (pSize == 1)
+            {
+                pStatement.PushBytes(lToken.mValue.data(), lToken.mValue.size());
+                return true;
+            }
+
+            for (const tmc::Char& lCharacter : lToken.mValue)
+            {
+                tmc::Byte lBytes[4] = { static_cast<tmc::Byte>(lCharacter), 0, 0, 0 };
+                pStatement.PushBytes(lBytes, pSize);
+            }
+
+            return true;
+        }
+
+        tmc::Int64 lValue = 0;
+        switch (lToken.mType)
+        {
+            case TokenType::Char:           lValue = static_cast<tmc::Byte>(lToken.mValue.at(0)); break;
+            case TokenType::Number:         lValue = static_cast<tmc::Int64>(std::stod(lToken.mValue)); break;
+            case TokenType::Binary:         lValue = static_cast<tmc::Int64>(std::stoull(lToken.mValue, nullptr, 2)); break;
+            case TokenType::Octal:          lValue = static_cast<tmc::Int64>(std::stoull(lToken.mValue, nullptr, 8)); break;
+            default:                        lValue = static_cast<tmc::Int64>(std::stoull(lToken.mValue, nullptr, 16)); break;
+        }
+
+        if (lNegative == true)
+        {
+            lValue = -lValue;
+        }
+
+        if (IsInRange(lValue, pSize, false) == false)
+        {
+            std::cerr << "[Parser] Value " << lValue << " does not fit in " << pSize << " byte(s)." << std::endl;
+            return false;
+        }
+
+        // All values are stored little-endian.
+        tmc::Byte lBytes[4] = {};
+        for (tmc::Index lIndex = 0; lIndex < pSize; ++lIndex)
+        {
+            lBytes[lIndex] = static_cast<tmc::Byte>((lValue >> (lIndex * 8)) & 0xFF);
+        }
+
+        pStatement.PushBytes(lBytes, pSize);
+        return true;
+    }
+
+    Statement::Ptr Parser::ParseIncbin (Lexer& pLexer)
+    {
+        // Discard the 'incbin' keyword. A file name follows, then an optional offset and length.
+        pLexer.DiscardToken();
+
+        Token lPathToken = pLexer.DiscardToken();
+        if (lPathToken.mType != TokenType::String)
+        {
+            std::cerr << "[Parser] Expected a file name after 'incbin'." << std::endl;
+            return nullptr;
+        }
+
+        Expression::Ptr lOffsetExpression = nullptr, lLengthExpression = nullptr;
+        if (pLexer.DiscardTokenIf(TokenType::Comma) == true)
+        {
+            lOffsetExpression = ParseExpression(pLexer);
+            if (lOffsetExpression == nullptr) { return nullptr; }
+
+            if (pLexer.DiscardTokenIf(TokenType::Comma) == true)
+            {
+                lLengthExpression = ParseExpression(pLexer);
+                if (lLengthExpression == nullptr) { return nullptr; }
+            }
+        }
+
+        return Statement::Make<IncbinStatement>(lPathToken.mValue, lOffsetExpression, lLengthExpression);
+    }
+
     Statement::Ptr Parser::ParseInstruction (Lexer& pLexer)
     {
         // Discard the leading token, but keep track of its keyword.
@@ -162,6 +338,80 @@ namespace tmm
             lFirstOperandExpression, lSecondOperandExpression);
     }
 
+    Statement::Ptr Parser::ParseMacro (Lexer& pLexer)
+    {
+        pLexer.DiscardToken();      // Discard the 'MACRO' token.
+
+        // The macro's name must be a plain identifier.
+        Token lNameToken = pLexer.DiscardToken();
+        if (lNameToken.mType != TokenType::Identifier)
+        {
+            std::cerr << "[Parser] Expected identifier after 'macro' keyword." << std::endl;
+            return nullptr;
+        }
+
+        // Parse the macro's body once, up to the matching 'ENDM'. Invocations are expanded from
+        // these nodes, so the body is never lexed or parsed again.
+        Statement::Body lBody;
+        while (true)
+        {
+            const auto& lToken = pLexer.TokenAt();
+            const auto& lKeyword = lToken.GetKeyword();
+
+            if (lToken.mType == TokenType::EndOfFile)
+            {
+                std::cerr << "[Parser] Missing 'endm' at end of macro '" << lNameToken.mValue << "'." << std::endl;
+                return nullptr;
+            }
+            else if (lKeyword.mType == KeywordType::Language && lKeyword.mParamOne == LanguageType::LT_ENDM)
+            {
+                pLexer.DiscardToken();
+                break;
+            }
+            else if (lKeyword.mType == KeywordType::Language && lKeyword.mParamOne == LanguageType::LT_MACRO)
+            {
+                std::cerr << "[Parser] Macro definitions cannot be nested." << std::endl;
+                return nullptr;
+            }
+
+            const tmc::Index lFile = InternFile(lToken.mFile);
+            const tmc::Index lLine = lToken.mLine;
+
+            Statement::Ptr lStatement = ParseStatement(pLexer);
+            if (lStatement == nullptr) { return nullptr; }
+
+            lStatement->SetLocation(lFile, lLine);
+            lBody.push_back(lStatement);
+        }
+
+        mMacros.insert(lNameToken.mValue);
+        return Statement::Make<MacroStatement>(lNameToken.mValue, lBody);
+    }
+
+    Statement::Ptr Parser::ParseMacroCall (Lexer& pLexer)
+    {
+        // Keep the name token; the macro's arguments are the expressions on the same line.
+        Token lNameToken = pLexer.DiscardToken();
+        Expression::Body lArguments;
+
+        while (pLexer.TokenAt().mType != TokenType::EndOfFile &&
+               pLexer.TokenAt().mLine == lNameToken.mLine &&
+               pLexer.TokenAt().mFile == lNameToken.mFile)
+        {
+            Expression::Ptr lExpression = ParseExpression(pLexer);
+            if (lExpression == nullptr) { return nullptr; }
+
+            lArguments.push_back(lExpression);
+
+            if (pLexer.DiscardTokenIf(TokenType::Comma) == false)
+            {
+                break;
+            }
+        }
+
+        return Statement::Make<MacroCallStatement>(lNameToken.mValue, lArguments);
+    }
+
     /* Private Methods - Parse Expressions ********************************************************/
 
     // Order of Expression Precedence:
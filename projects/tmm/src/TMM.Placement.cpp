@@ -0,0 +1,167 @@
+/// @file TMM.Placement.cpp
+
+#include <TMM.Precompiled.hpp>
+#include <TMM.Placement.hpp>
+
+namespace tmm
+{
+
+    /* Static Constants ***************************************************************************/
+
+    static constexpr tmc::Uint64 ADDRESS_SPACE_END = 0xFFFFFFFF;
+
+    /* Public Constructors and Destructor *********************************************************/
+
+    Placement::Placement ()
+    {
+        AddGap(0, ADDRESS_SPACE_END);
+    }
+
+    /* Public Methods *****************************************************************************/
+
+    tmc::Boolean Placement::Reserve (const tmc::Uint64& pStart, const tmc::Uint64& pSize,
+        const tmc::String& pName)
+    {
+        if (pSize == 0)
+        {
+            return true;
+        }
+
+        const tmc::Uint64 lEnd = pStart + pSize - 1;
+        if (lEnd > ADDRESS_SPACE_END)
+        {
+            std::cerr   << "[Placement] '" << pName << "' runs past the end of the address space."
+                        << std::endl;
+            return false;
+        }
+
+        if (const Range* lOverlap = FindOverlap(pStart, lEnd); lOverlap != nullptr)
+        {
+            std::cerr   << "[Placement] '" << pName << "' ($" << std::hex << pStart << " - $" << lEnd
+                        << ") overlaps '" << lOverlap->mName << "' ($" << lOverlap->mStart << " - $"
+                        << lOverlap->mEnd << ")." << std::dec << std::endl;
+            return false;
+        }
+
+        mRanges.emplace(pStart, Range { pStart, lEnd, pName });
+        TakeGap(pStart, lEnd);
+        return true;
+    }
+
+    tmc::Boolean Placement::Place (const tmc::Uint64& pSize, const tmc::Uint64& pLow,
+        const tmc::Uint64& pHigh, const tmc::String& pName, tmc::Uint64& pStart)
+    {
+        if (pSize == 0)
+        {
+            pStart = pLow;
+            return true;
+        }
+
+        // Best fit: the smallest part of a free range, within the bounds, which can hold the whole
+        // size. Each region keeps its own free ranges by size, so the first large enough is found
+        // without visiting those which lie outside it.
+        const GapSizes& lGaps = GetRegionGaps(pLow, pHigh);
+        if (auto lIter = lGaps.lower_bound({ pSize, 0 }); lIter != lGaps.end())
+        {
+            pStart = lIter->second;
+            return Reserve(pStart, pSize, pName);
+        }
+
+        std::cerr   << "[Placement] No free range of " << pSize << " bytes for '" << pName
+                    << "' between $" << std::hex << pLow << " and $" << pHigh << "." << std::dec
+                    << std::endl;
+        return false;
+    }
+
+    const Placement::Range* Placement::FindOverlap (const tmc::Uint64& pStart,
+        const tmc::Uint64& pEnd) const
+    {
+        // Placed ranges never overlap each other, so the only one which could overlap the given
+        // range is the last to start at or before its end.
+        auto lIter = mRanges.upper_bound(pEnd);
+        if (lIter == mRanges.begin())
+        {
+            return nullptr;
+        }
+
+        --lIter;
+        return (lIter->second.mEnd >= pStart) ? &lIter->second : nullptr;
+    }
+
+    /* Private Methods ****************************************************************************/
+
+    Placement::GapSizes& Placement::GetRegionGaps (const tmc::Uint64& pLow,
+        const tmc::Uint64& pHigh)
+    {
+        auto [lRegion, lAdded] = mRegionGaps.try_emplace({ pLow, pHigh });
+        if (lAdded == false)
+        {
+            return lRegion->second;
+        }
+
+        // A region is indexed when it is first placed into, from the free ranges which overlap it,
+        // and is then kept up to date as ranges are taken and freed.
+        auto lIter = mGaps.upper_bound(pLow);
+        if (lIter != mGaps.begin())
+        {
+            --lIter;
+        }
+
+        for (; lIter != mGaps.end() && lIter->first <= pHigh; ++lIter)
+        {
+            const tmc::Uint64 lLow  = std::max(lIter->first, pLow);
+            const tmc::Uint64 lHigh = std::min(lIter->second, pHigh);
+
+            if (lLow <= lHigh)
+            {
+                lRegion->second.emplace(lHigh - lLow + 1, lLow);
+            }
+        }
+
+        return lRegion->second;
+    }
+
+    void Placement::TakeGap (const tmc::Uint64& pStart, const tmc::Uint64& pEnd)
+    {
+        // The free ranges are the complement of the placed ones, so exactly one holds the range.
+        auto lIter = std::prev(mGaps.upper_bound(pStart));
+        const tmc::Uint64 lGapStart = lIter->first;
+        const tmc::Uint64 lGapEnd   = lIter->second;
+
+        IndexGap(lGapStart, lGapEnd, false);
+        mGaps.erase(lIter);
+
+        if (lGapStart < pStart)     { AddGap(lGapStart, pStart - 1); }
+        if (pEnd < lGapEnd)         { AddGap(pEnd + 1, lGapEnd); }
+    }
+
+    void Placement::AddGap (const tmc::Uint64& pStart, const tmc::Uint64& pEnd)
+    {
+        mGaps.emplace(pStart, pEnd);
+        IndexGap(pStart, pEnd, true);
+    }
+
+    void Placement::IndexGap (const tmc::Uint64& pStart, const tmc::Uint64& pEnd,
+        const tmc::Boolean& pFree)
+    {
+        for (auto& [lBounds, lGaps] : mRegionGaps)
+        {
+            const tmc::Uint64 lLow  = std::max(pStart, lBounds.first);
+            const tmc::Uint64 lHigh = std::min(pEnd, lBounds.second);
+
+            if (lLow > lHigh)
+            {
+                continue;
+            }
+            else if (pFree == true)
+            {
+                lGaps.emplace(lHigh - lLow + 1, lLow);
+            }
+            else
+            {
+                lGaps.erase({ lHigh - lLow + 1, lLow });
+            }
+        }
+    }
+
+}
@@ -0,0 +1,234 @@
+/// @file TMM.Server.cpp
+
+#include <TMM.Precompiled.hpp>
+#include <TMM.Server.hpp>
+#include <TMM.Lexer.hpp>
+#include <TMC.Arguments.hpp>
+
+#if defined(TM_LINUX)
+    #include <unistd.h>
+    #include <poll.h>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+#endif
+
+namespace tmm
+{
+
+    /* Capture Buffer Class ***********************************************************************/
+
+    // Collects a request's output. Unbuffered, so that the lock covers every write, even those
+    // from the assembler's worker threads.
+    class CaptureBuffer : public std::streambuf
+    {
+    public:
+        inline const tmc::String& GetText () const { return mText; }
+
+    protected:
+        std::streamsize xsputn (const tmc::Char* pData, std::streamsize pCount) override
+        {
+            std::lock_guard lLock { mMutex };
+            mText.append(pData, static_cast<tmc::Index>(pCount));
+            return pCount;
+        }
+
+        int_type overflow (int_type pCharacter) override
+        {
+            if (traits_type::eq_int_type(pCharacter, traits_type::eof()) == false)
+            {
+                std::lock_guard lLock { mMutex };
+                mText.push_back(traits_type::to_char_type(pCharacter));
+            }
+
+            return traits_type::not_eof(pCharacter);
+        }
+
+    private:
+        std::mutex      mMutex;
+        tmc::String     mText;
+
+    };
+
+    /* Public Constructors and Destructor *********************************************************/
+
+    Server::Server (const tmc::Path& pSocketPath, const Handler& pHandler) :
+        mSocketPath { pSocketPath },
+        mHandler    { pHandler }
+    {
+
+    }
+
+    /* Public Methods *****************************************************************************/
+
+    tmc::Boolean Server::Run ()
+    {
+    #if defined(TM_LINUX)
+        ::sockaddr_un lAddress {};
+        lAddress.sun_family = AF_UNIX;
+
+        const tmc::String lPath = mSocketPath.string();
+        if (lPath.empty() == true || lPath.size() >= sizeof(lAddress.sun_path))
+        {
+            std::cerr << "[Server] Invalid socket path '" << lPath << "'." << std::endl;
+            return false;
+        }
+
+        std::copy(lPath.begin(), lPath.end(), lAddress.sun_path);
+
+        // A socket left behind by a previous server is replaced; anything else is not.
+        std::error_code lError;
+        if (fs::is_socket(mSocketPath, lError) == true)
+        {
+            fs::remove(mSocketPath, lError);
+        }
+
+        tmc::Int32 lSocket = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (lSocket < 0 ||
+            ::bind(lSocket, reinterpret_cast<const ::sockaddr*>(&lAddress), sizeof(lAddress)) != 0 ||
+            ::listen(lSocket, SOMAXCONN) != 0)
+        {
+            std::cerr << "[Server] Could not listen on '" << lPath << "'." << std::endl;
+            if (lSocket >= 0) { ::close(lSocket); }
+            return false;
+        }
+
+        Lexer::SetModuleCaching(true);
+        std::cout << "[Server] Listening on '" << lPath << "'." << std::endl;
+
+        tmc::Boolean lRunning = true;
+        while (lRunning == true)
+        {
+            tmc::Int32 lClient = ::accept4(lSocket, nullptr, nullptr, SOCK_CLOEXEC);
+            if (lClient < 0)
+            {
+                if (errno == EINTR || errno == ECONNABORTED) { continue; }
+
+                std::cerr << "[Server] Could not accept a connection." << std::endl;
+                break;
+            }
+
+            lRunning = Serve(lClient);
+            ::close(lClient);
+        }
+
+        ::close(lSocket);
+        fs::remove(mSocketPath, lError);
+        Lexer::SetModuleCaching(false);
+
+        return lRunning == false;
+    #else
+        std::cerr << "[Server] Serving requests is only supported on Linux." << std::endl;
+        return false;
+    #endif
+    }
+
+    /* Private Methods ****************************************************************************/
+
+    tmc::Boolean Server::Serve (const tmc::Int32& pClient)
+    {
+    #if defined(TM_LINUX)
+        // Read up to the empty string which ends the request, which must arrive in full before
+        // the deadline. The response is sent under the same limit, reset.
+        const auto lDeadline = std::chrono::steady_clock::now() + std::chrono::milliseconds { CLIENT_TIMEOUT_MS };
+        const ::timeval lSendTimeout { CLIENT_TIMEOUT_MS / 1000, (CLIENT_TIMEOUT_MS % 1000) * 1000 };
+        ::setsockopt(pClient, SOL_SOCKET, SO_SNDTIMEO, &lSendTimeout, sizeof(lSendTimeout));
+
+        tmc::List<tmc::String> lStrings;
+        tmc::String lRequest = "";
+        tmc::Index lStart = 0;
+        tmc::Char lChunk[4096];
+
+        while (lStrings.empty() == true || lStrings.back().empty() == false)
+        {
+            const auto lRemaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                lDeadline - std::chrono::steady_clock::now()).count();
+            ::pollfd lPoll { pClient, POLLIN, 0 };
+            if (lRemaining <= 0 || ::poll(&lPoll, 1, static_cast<tmc::Int32>(lRemaining)) <= 0)
+            {
+                std::cerr << "[Server] Dropped a client which did not send its request in time." << std::endl;
+                return true;
+            }
+
+            ::ssize_t lRead = ::recv(pClient, lChunk, sizeof(lChunk), 0);
+            if (lRead <= 0 || lRequest.size() + lRead > MAX_REQUEST_SIZE)
+            {
+                return true;
+            }
+
+            lRequest.append(lChunk, static_cast<tmc::Index>(lRead));
+            for (tmc::Index lEnd = lRequest.find('\0', lStart); lEnd != tmc::String::npos;
+                lEnd = lRequest.find('\0', lStart))
+            {
+                lStrings.push_back(lRequest.substr(lStart, lEnd - lStart));
+                lStart = lEnd + 1;
+
+                if (lStrings.back().empty() == true) { break; }
+            }
+        }
+
+        lStrings.pop_back();
+        if (lStrings.empty() == true)
+        {
+            return true;
+        }
+
+        const tmc::Boolean lStop = lStrings.size() == 2 && lStrings[1] == "--stop";
+
+        // Each request sees its own working directory and arguments, as a new process would.
+        tmc::List<tmc::Char*> lArguments { const_cast<tmc::Char*>("tmm") };
+        for (tmc::Index lIndex = 1; lIndex < lStrings.size(); ++lIndex)
+        {
+            lArguments.push_back(lStrings[lIndex].data());
+        }
+
+        CaptureBuffer lOutput;
+        tmc::Int32 lResult = 0;
+
+        if (lStop == false)
+        {
+            std::error_code lError;
+            const tmc::Path lServerDirectory = fs::current_path(lError);
+            fs::current_path(lStrings[0], lError);
+
+            std::streambuf* lCout = std::cout.rdbuf(&lOutput);
+            std::streambuf* lCerr = std::cerr.rdbuf(&lOutput);
+
+            if (lError)
+            {
+                std::cerr << "[Server] Could not change to directory '" << lStrings[0] << "'." << std::endl;
+                lResult = 1;
+            }
+            else
+            {
+                tmc::Arguments::Clear();
+                tmc::Arguments::Capture(static_cast<tmc::Int32>(lArguments.size()), lArguments.data());
+                lResult = mHandler();
+            }
+
+            std::cout.rdbuf(lCout);
+            std::cerr.rdbuf(lCerr);
+            fs::current_path(lServerDirectory, lError);
+        }
+
+        // Send the exit code, then the output. A client which hangs up early does not matter.
+        tmc::String lResponse(4, '\0');
+        for (tmc::Index lIndex = 0; lIndex < 4; ++lIndex)
+        {
+            lResponse[lIndex] = static_cast<tmc::Char>((static_cast<tmc::Uint32>(lResult) >> (lIndex * 8)) & 0xFF);
+        }
+
+        lResponse += lOutput.GetText();
+        for (tmc::Index lSent = 0; lSent < lResponse.size(); )
+        {
+            ::ssize_t lWritten = ::send(pClient, lResponse.data() + lSent, lResponse.size() - lSent, MSG_NOSIGNAL);
+            if (lWritten <= 0) { break; }
+            lSent += static_cast<tmc::Index>(lWritten);
+        }
+
+        return lStop == false;
+    #else
+        return false;
+    #endif
+    }
+
+}
@@ -0,0 +1,284 @@
+/// @file TMM.Stats.cpp
+
+#include <TMM.Precompiled.hpp>
+#include <TMM.Stats.hpp>
+
+#if defined(TM_LINUX)
+    #include <sys/resource.h>
+#endif
+
+/* Allocation Counters ****************************************************************************/
+
+// Every heap allocation made by the assembler passes through the replaced global allocation
+// functions below. The counters are per-thread, so that each worker in a batch build sees only
+// its own file's allocations, and need no synchronization; a thread which helps with a file's
+// work hands its counts to that file's thread through 'Stats::Charge' when it finishes. The array
+// and 'nothrow' forms forward to these by default.
+static thread_local tmc::Uint64 sAllocationCount    = 0;
+static thread_local tmc::Uint64 sAllocatedBytes     = 0;
+
+void* operator new (std::size_t pSize)
+{
+    sAllocationCount += 1;
+    sAllocatedBytes  += pSize;
+
+    void* lPointer = std::malloc(pSize > 0 ? pSize : 1);
+    if (lPointer == nullptr)
+    {
+        throw std::bad_alloc {};
+    }
+
+    return lPointer;
+}
+
+#if defined(TM_LINUX)
+
+void* operator new (std::size_t pSize, std::align_val_t pAlignment)
+{
+    sAllocationCount += 1;
+    sAllocatedBytes  += pSize;
+
+    const std::size_t lAlignment = std::max<std::size_t>(static_cast<std::size_t>(pAlignment),
+        sizeof(void*));
+
+    void* lPointer = nullptr;
+    if (::posix_memalign(&lPointer, lAlignment, pSize > 0 ? pSize : 1) != 0)
+    {
+        throw std::bad_alloc {};
+    }
+
+    return lPointer;
+}
+
+#endif
+
+void operator delete (void* pPointer) noexcept
+{
+    std::free(pPointer);
+}
+
+void operator delete (void* pPointer, std::size_t) noexcept
+{
+    std::free(pPointer);
+}
+
+#if defined(TM_LINUX)
+
+void operator delete (void* pPointer, std::align_val_t) noexcept
+{
+    std::free(pPointer);
+}
+
+void operator delete (void* pPointer, std::size_t, std::align_val_t) noexcept
+{
+    std::free(pPointer);
+}
+
+#endif
+
+namespace tmm
+{
+
+    /* Static Members *****************************************************************************/
+
+    std::mutex Stats::sReportMutex;
+
+    /* Static Functions ***************************************************************************/
+
+    static tmc::String EscapeJSON (const tmc::String& pString)
+    {
+        static constexpr const tmc::Char* HEX_DIGITS = "0123456789abcdef";
+
+        tmc::String lEscaped;
+        for (const tmc::Char& lChar : pString)
+        {
+            switch (lChar)
+            {
+                case '"':   lEscaped += "\\\""; break;
+                case '\\':  lEscaped += "\\\\"; break;
+                case '\n':  lEscaped += "\\n";  break;
+                case '\t':  lEscaped += "\\t";  break;
+                default:
+                    if (static_cast<tmc::Byte>(lChar) < 0x20)
+                    {
+                        lEscaped += "\\u00";
+                        lEscaped += HEX_DIGITS[(lChar >> 4) & 0xF];
+                        lEscaped += HEX_DIGITS[lChar & 0xF];
+                    }
+                    else
+                    {
+                        lEscaped += lChar;
+                    }
+                    break;
+            }
+        }
+
+        return lEscaped;
+    }
+
+    /* Public Constructors and Destructor *********************************************************/
+
+    Stats::Stats (const tmc::String& pInput, const StatsFormat& pFormat) :
+        mInput  { pInput },
+        mFormat { pFormat }
+    {
+        Begin();
+    }
+
+    /* Public Methods *****************************************************************************/
+
+    void Stats::Begin ()
+    {
+        mStart              = std::chrono::steady_clock::now();
+        mStartAllocations   = GetAllocationCount();
+        mStartBytes         = GetAllocatedBytes();
+    }
+
+    void Stats::End (const tmc::String& pName, const tmc::Index& pCount, const tmc::String& pUnit)
+    {
+        if (IsEnabled() == false)
+        {
+            return;
+        }
+
+        // The counters are read before the phase record is built, so that its own allocations
+        // are charged to the next phase rather than to this one.
+        const auto          lEnd            = std::chrono::steady_clock::now();
+        const tmc::Uint64   lAllocations    = GetAllocationCount() - mStartAllocations;
+        const tmc::Uint64   lBytes          = GetAllocatedBytes() - mStartBytes;
+
+        Phase lPhase;
+        lPhase.mName            = pName;
+        lPhase.mUnit            = pUnit;
+        lPhase.mCount           = pCount;
+        lPhase.mSeconds         = std::chrono::duration<tmc::Float64> { lEnd - mStart }.count();
+        lPhase.mAllocations     = lAllocations;
+        lPhase.mAllocatedBytes  = lBytes;
+        lPhase.mPeakRSS         = GetPeakRSS();
+        mPhases.push_back(std::move(lPhase));
+
+        Begin();
+    }
+
+    void Stats::Report () const
+    {
+        if (IsEnabled() == false)
+        {
+            return;
+        }
+
+        // Each report is written whole, so that those of a parallel batch build do not interleave.
+        const tmc::String lReport = (mFormat == StatsFormat::JSON) ? FormatJSON() : FormatText();
+
+        std::lock_guard lLock { sReportMutex };
+        std::cout << lReport << std::flush;
+    }
+
+    /* Public Static Methods **********************************************************************/
+
+    StatsFormat Stats::ParseFormat (const tmc::String& pFormat)
+    {
+        if (pFormat.empty() == true || pFormat == "text")
+        {
+            return StatsFormat::Text;
+        }
+        else if (pFormat == "json")
+        {
+            return StatsFormat::JSON;
+        }
+
+        return StatsFormat::None;
+    }
+
+    tmc::Uint64 Stats::GetAllocationCount ()
+    {
+        return sAllocationCount;
+    }
+
+    tmc::Uint64 Stats::GetAllocatedBytes ()
+    {
+        return sAllocatedBytes;
+    }
+
+    void Stats::Charge (const tmc::Uint64& pAllocations, const tmc::Uint64& pBytes)
+    {
+        sAllocationCount += pAllocations;
+        sAllocatedBytes  += pBytes;
+    }
+
+    tmc::Uint64 Stats::GetPeakRSS ()
+    {
+    #if defined(TM_LINUX)
+        struct rusage lUsage {};
+        if (::getrusage(RUSAGE_SELF, &lUsage) == 0)
+        {
+            return static_cast<tmc::Uint64>(lUsage.ru_maxrss) * 1024;
+        }
+    #endif
+
+        return 0;
+    }
+
+    /* Private Methods ****************************************************************************/
+
+    tmc::String Stats::FormatText () const
+    {
+        std::ostringstream lStream;
+        lStream << "[Stats] '" << mInput << "':\n";
+        lStream << "    " << std::left << std::setw(10) << "Phase" << std::right
+                << std::setw(12) << "Time (ms)" << std::setw(22) << "Output"
+                << std::setw(14) << "Allocations" << std::setw(16) << "Allocated (KiB)"
+                << std::setw(16) << "Peak RSS (KiB)" << "\n";
+
+        Phase lTotal;
+        lTotal.mName = "total";
+
+        for (const Phase& lPhase : mPhases)
+        {
+            lStream << "    " << std::left << std::setw(10) << lPhase.mName << std::right
+                    << std::setw(12) << std::fixed << std::setprecision(3) << lPhase.mSeconds * 1000.0
+                    << std::setw(22) << (std::to_string(lPhase.mCount) + " " + lPhase.mUnit)
+                    << std::setw(14) << lPhase.mAllocations
+                    << std::setw(16) << std::setprecision(1) << lPhase.mAllocatedBytes / 1024.0
+                    << std::setw(16) << lPhase.mPeakRSS / 1024 << "\n";
+
+            lTotal.mSeconds         += lPhase.mSeconds;
+            lTotal.mAllocations     += lPhase.mAllocations;
+            lTotal.mAllocatedBytes  += lPhase.mAllocatedBytes;
+            lTotal.mPeakRSS         = std::max(lTotal.mPeakRSS, lPhase.mPeakRSS);
+        }
+
+        lStream << "    " << std::left << std::setw(10) << lTotal.mName << std::right
+                << std::setw(12) << std::fixed << std::setprecision(3) << lTotal.mSeconds * 1000.0
+                << std::setw(22) << ""
+                << std::setw(14) << lTotal.mAllocations
+                << std::setw(16) << std::setprecision(1) << lTotal.mAllocatedBytes / 1024.0
+                << std::setw(16) << lTotal.mPeakRSS / 1024 << "\n";
+
+        return lStream.str();
+    }
+
+    tmc::String Stats::FormatJSON () const
+    {
+        // One object per line, so that a batch build's reports can be read as JSON Lines.
+        std::ostringstream lStream;
+        lStream << "{\"input\":\"" << EscapeJSON(mInput) << "\",\"phases\":[";
+
+        for (tmc::Index lIndex = 0; lIndex < mPhases.size(); ++lIndex)
+        {
+            const Phase& lPhase = mPhases[lIndex];
+            lStream << ((lIndex > 0) ? "," : "")
+                    << "{\"name\":\"" << lPhase.mName << "\""
+                    << ",\"seconds\":" << std::setprecision(9) << lPhase.mSeconds
+                    << ",\"count\":" << lPhase.mCount
+                    << ",\"unit\":\"" << lPhase.mUnit << "\""
+                    << ",\"allocations\":" << lPhase.mAllocations
+                    << ",\"allocated_bytes\":" << lPhase.mAllocatedBytes
+                    << ",\"peak_rss_bytes\":" << lPhase.mPeakRSS << "}";
+        }
+
+        lStream << "]}\n";
+        return lStream.str();
+    }
+
+}
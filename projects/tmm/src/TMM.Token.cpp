@@ -85,6 +85,20 @@ namespace tmm
         return Keyword::Lookup(mValue);
     }
 
+    const Keyword& Token::GetDirective () const
+    {
+        // 'DB' and 'DS' are lexed as identifiers, keeping their case; 'DW' and 'DL' as registers.
+        if (mType != TokenType::Identifier && mType != TokenType::Keyword)
+        {
+            return Keyword::LookupDirective("");
+        }
+
+        tmc::String lUppercase = mValue;
+        std::transform(lUppercase.begin(), lUppercase.end(), lUppercase.begin(),
+            [] (const char pCharacter) { return static_cast<char>(std::toupper(pCharacter)); });
+        return Keyword::LookupDirective(lUppercase);
+    }
+
     tmc::Boolean Token::IsOperator () const
     {
         switch (mType)
@@ -0,0 +1,404 @@
+/// @file TMM.Writer.cpp
+
+#include <TMM.Precompiled.hpp>
+#include <TMM.Writer.hpp>
+#include <TMC.LineTable.hpp>
+#include <TMC.CodeMap.hpp>
+
+#if defined(TM_LINUX)
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <climits>
+    #include <sys/uio.h>
+#endif
+
+namespace tmm
+{
+
+    /* Static Functions ***************************************************************************/
+
+    static void CopyField (tmc::ByteBuffer& pBuffer, const tmc::Address& pAddress,
+        const tmc::String& pValue, const tmc::Index& pLength)
+    {
+        // Fields are truncated to fit, and the remainder (including the terminator) stays zero.
+        // Only ASCII characters are allowed.
+        std::transform(pValue.begin(), pValue.begin() + std::min(pValue.size(), pLength),
+            pBuffer.begin() + pAddress, [] (const tmc::Char& pCharacter)
+            {
+                return static_cast<tmc::Byte>((pCharacter & 0x80) ? '?' : pCharacter);
+            });
+    }
+
+    static void CopyLong (tmc::ByteBuffer& pBuffer, const tmc::Address& pAddress, const tmc::Long& pValue)
+    {
+        for (tmc::Index lIndex = 0; lIndex < 4; ++lIndex)
+        {
+            pBuffer[pAddress + lIndex] = static_cast<tmc::Byte>((pValue >> (lIndex * 8)) & 0xFF);
+        }
+    }
+
+    static tmc::Boolean EndsBlock (const Fragment& pFragment)
+    {
+        // Any transfer of control, taken or not, ends a basic block; so does a call, since control
+        // comes back to the instruction after it from elsewhere.
+        switch (pFragment.GetOpcode() >> 8)
+        {
+            case 0x20:  // JMP X, [A32]
+            case 0x21:  // JMP X, [Y]
+            case 0x22:  // JPB X, S16
+            case 0x23:  // CALL X, [A32]
+            case 0x24:  // RST [XX]
+            case 0x25:  // RET X
+            case 0x26:  // RETI
+            case 0xFF:  // JPS
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    /* Public Constructors and Destructor *********************************************************/
+
+    Writer::Writer (const Object& pObject) :
+        mObject { pObject }
+    {
+
+    }
+
+    /* Public Methods *****************************************************************************/
+
+    void Writer::SetProgramName (const tmc::String& pName)
+    {
+        mName = pName;
+    }
+
+    void Writer::SetProgramAuthor (const tmc::String& pAuthor)
+    {
+        mAuthor = pAuthor;
+    }
+
+    void Writer::SetRequestedRAMSize (const tmc::Long& pSize)
+    {
+        mRAMSize = pSize;
+    }
+
+    tmc::Index Writer::GetImageSize () const
+    {
+        tmc::Index lSize = tmc::PROGRAM_EXTRA_METADATA_START;
+        for (tmc::Int32 lType = 0; lType < SectionType::ST_COUNT; ++lType)
+        {
+            const Section& lSection = mObject.GetSection(lType);
+            if (lSection.IsRAM() == false && lSection.IsEmpty() == false)
+            {
+                lSize = std::max<tmc::Index>(lSize, lSection.mStart + lSection.mSize);
+            }
+        }
+
+        return lSize;
+    }
+
+    tmc::Boolean Writer::WriteROM (const tmc::Path& pPath) const
+    {
+        const tmc::Index lImageSize = GetImageSize();
+        const tmc::ByteBuffer lMetadata = BuildMetadata();
+
+        // Sections are written in address order. Each run of adjacent code and data fragments is
+        // gathered into one vectored write straight from the fragments' buffers, or from the
+        // files they include; the gaps between sections and 'DS' regions are never written, and
+        // so are left as holes in the file.
+    #if defined(TM_LINUX)
+        tmc::Int32 lFile = ::open(pPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (lFile < 0)
+        {
+            std::cerr << "[Writer] Could not open '" << pPath.string() << "' for writing." << std::endl;
+            return false;
+        }
+
+        tmc::List<::iovec> lVectors;
+        tmc::Index lOffset = 0;
+        tmc::Boolean lGood = ::ftruncate(lFile, static_cast<::off_t>(lImageSize)) == 0;
+
+        auto lFlush = [&] ()
+        {
+            tmc::Index lVector = 0;
+            while (lGood == true && lVector < lVectors.size())
+            {
+                ::ssize_t lWritten = ::pwritev(lFile, lVectors.data() + lVector,
+                    static_cast<tmc::Int32>(lVectors.size() - lVector), static_cast<::off_t>(lOffset));
+                if (lWritten <= 0)
+                {
+                    lGood = false;
+                    break;
+                }
+
+                // Skip over whatever the kernel accepted; a short write resumes mid-vector.
+                lOffset += static_cast<tmc::Index>(lWritten);
+                while (lVector < lVectors.size() && static_cast<tmc::Index>(lWritten) >= lVectors[lVector].iov_len)
+                {
+                    lWritten -= static_cast<::ssize_t>(lVectors[lVector++].iov_len);
+                }
+
+                if (lVector < lVectors.size())
+                {
+                    lVectors[lVector].iov_base = static_cast<tmc::Byte*>(lVectors[lVector].iov_base) + lWritten;
+                    lVectors[lVector].iov_len -= static_cast<tmc::Index>(lWritten);
+                }
+            }
+
+            lVectors.clear();
+        };
+
+        lVectors.push_back({ const_cast<tmc::Byte*>(lMetadata.data()), lMetadata.size() });
+        lFlush();
+
+        for (tmc::Int32 lType = 0; lType < SectionType::ST_COUNT && lGood == true; ++lType)
+        {
+            const Section& lSection = mObject.GetSection(lType);
+            if (lSection.IsRAM() == true) { continue; }
+
+            for (const Fragment& lFragment : lSection.mFragments)
+            {
+                if (lFragment.mType == FragmentType::Label || lFragment.GetSize() == 0)
+                {
+                    continue;
+                }
+                else if (lFragment.mType == FragmentType::Space)
+                {
+                    lFlush();
+                    continue;
+                }
+
+                if (lVectors.empty() == true)
+                {
+                    lOffset = lFragment.mAddress;
+                }
+
+                lVectors.push_back({ const_cast<tmc::Byte*>(lFragment.GetData()), lFragment.GetSize() });
+                if (lVectors.size() == IOV_MAX)
+                {
+                    lFlush();
+                }
+            }
+
+            lFlush();
+        }
+
+        lGood = (::close(lFile) == 0) && lGood;
+    #else
+        tmc::File lFile { pPath, std::ios::out | std::ios::binary | std::ios::trunc };
+        tmc::Boolean lGood = lFile.is_open();
+
+        if (lGood == true)
+        {
+            lFile.write(reinterpret_cast<const tmc::Char*>(lMetadata.data()), lMetadata.size());
+        }
+
+        for (tmc::Int32 lType = 0; lType < SectionType::ST_COUNT && lGood == true; ++lType)
+        {
+            const Section& lSection = mObject.GetSection(lType);
+            if (lSection.IsRAM() == true) { continue; }
+
+            for (const Fragment& lFragment : lSection.mFragments)
+            {
+                if (lFragment.GetData() == nullptr || lFragment.GetSize() == 0)
+                {
+                    continue;
+                }
+
+                lFile.seekp(lFragment.mAddress);
+                lFile.write(reinterpret_cast<const tmc::Char*>(lFragment.GetData()), lFragment.GetSize());
+            }
+        }
+
+        lFile.close();
+        lGood = lGood && lFile.good();
+
+        std::error_code lError;
+        fs::resize_file(pPath, lImageSize, lError);
+        lGood = lGood && !lError;
+    #endif
+
+        if (lGood == false)
+        {
+            std::cerr << "[Writer] Could not write ROM image '" << pPath.string() << "'." << std::endl;
+        }
+
+        return lGood;
+    }
+
+    tmc::Boolean Writer::WriteMap (const tmc::Path& pPath) const
+    {
+        tmc::File lFile { pPath, std::ios::out | std::ios::trunc };
+        if (lFile.is_open() == false)
+        {
+            std::cerr << "[Writer] Could not open '" << pPath.string() << "' for writing." << std::endl;
+            return false;
+        }
+
+        struct Symbol
+        {
+            tmc::Address        mAddress    = 0;
+            const Section*      mSection    = nullptr;
+            const Fragment*     mFragment   = nullptr;
+        };
+
+        tmc::List<Symbol> lSymbols;
+        const tmc::List<tmc::Path>& lFiles = mObject.GetFiles();
+
+        lFile << std::hex << std::uppercase << std::setfill('0');
+        lFile << "Sections:\n";
+        for (tmc::Int32 lType = 0; lType < SectionType::ST_COUNT; ++lType)
+        {
+            const Section& lSection = mObject.GetSection(lType);
+            if (lSection.IsEmpty() == true) { continue; }
+
+            lFile   << "  $" << std::setw(8) << lSection.mStart << " - $" << std::setw(8)
+                    << (lSection.mStart + lSection.mSize - 1) << "  " << lSection.GetName() << " ("
+                    << std::dec << lSection.mSize << " bytes)" << std::hex << "\n";
+
+            for (const Fragment& lFragment : lSection.mFragments)
+            {
+                if (lFragment.mType == FragmentType::Label)
+                {
+                    lSymbols.push_back({ lFragment.mAddress, &lSection, &lFragment });
+                }
+            }
+        }
+
+        // Sections are already in address order, but keep the symbol listing sorted regardless.
+        std::stable_sort(lSymbols.begin(), lSymbols.end(),
+            [] (const Symbol& pLeft, const Symbol& pRight) { return pLeft.mAddress < pRight.mAddress; });
+
+        lFile << "\nSymbols:\n";
+        for (const Symbol& lSymbol : lSymbols)
+        {
+            lFile   << "  $" << std::setw(8) << lSymbol.mAddress << "  " << std::left << std::setfill(' ')
+                    << std::setw(8) << lSymbol.mSection->GetName() << "  " << lSymbol.mFragment->mLabel
+                    << std::right << std::setfill('0');
+
+            if (lSymbol.mFragment->mFile < lFiles.size())
+            {
+                lFile   << "  (" << lFiles[lSymbol.mFragment->mFile].string() << ":" << std::dec
+                        << lSymbol.mFragment->mLine << std::hex << ")";
+            }
+
+            lFile << "\n";
+        }
+
+        lFile.close();
+        if (lFile.good() == false)
+        {
+            std::cerr << "[Writer] Could not write map file '" << pPath.string() << "'." << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    tmc::Boolean Writer::WriteLineTable (const tmc::Path& pPath) const
+    {
+        tmc::LineTable lTable;
+        for (const tmc::Path& lPath : mObject.GetFiles())
+        {
+            lTable.AddFile(lPath.string());
+        }
+
+        // One row wherever an emitted fragment begins; the table itself drops rows which do not
+        // change the location. Reserved space and the end of each section map to no source line.
+        for (tmc::Int32 lType = 0; lType < SectionType::ST_COUNT; ++lType)
+        {
+            const Section& lSection = mObject.GetSection(lType);
+            if (lSection.IsRAM() == true || lSection.IsEmpty() == true) { continue; }
+
+            for (const Fragment& lFragment : lSection.mFragments)
+            {
+                if (lFragment.mType == FragmentType::Label || lFragment.GetSize() == 0)
+                {
+                    continue;
+                }
+                else if (lFragment.mType == FragmentType::Space || lFragment.mFile == tmc::NPOS)
+                {
+                    lTable.AddRow(lFragment.mAddress, 0, 0);
+                }
+                else
+                {
+                    lTable.AddRow(lFragment.mAddress, static_cast<tmc::Uint32>(lFragment.mFile),
+                        static_cast<tmc::Uint32>(lFragment.mLine));
+                }
+            }
+
+            lTable.AddRow(static_cast<tmc::Address>(lSection.mStart + lSection.mSize), 0, 0);
+        }
+
+        lTable.Build();
+        return lTable.Save(pPath);
+    }
+
+    tmc::Boolean Writer::WriteCodeMap (const tmc::Path& pPath) const
+    {
+        tmc::CodeMap lMap;
+
+        // The metadata header ahead of the 'METADATA' section is written by the writer itself.
+        lMap.AddRange(tmc::PROGRAM_METADATA_START, tmc::PROGRAM_EXTRA_METADATA_START,
+            tmc::CodeMap::Kind::Data);
+
+        // A basic block begins at the first instruction after anything which is not one - the
+        // start of a section, a label or data - and after any instruction which ends a block.
+        for (tmc::Int32 lType = 0; lType < SectionType::ST_COUNT; ++lType)
+        {
+            const Section& lSection = mObject.GetSection(lType);
+            if (lSection.IsRAM() == true || lSection.IsEmpty() == true) { continue; }
+
+            tmc::Boolean lLeader = true;
+            for (const Fragment& lFragment : lSection.mFragments)
+            {
+                const tmc::Index lSize = lFragment.GetSize();
+                if (lFragment.mType == FragmentType::Label)
+                {
+                    lLeader = true;
+                    continue;
+                }
+                else if (lSize == 0)
+                {
+                    continue;
+                }
+                else if (lFragment.mType != FragmentType::Code)
+                {
+                    lMap.AddRange(lFragment.mAddress, static_cast<tmc::Long>(lSize), tmc::CodeMap::Kind::Data);
+                    lLeader = true;
+                    continue;
+                }
+
+                lMap.AddRange(lFragment.mAddress, static_cast<tmc::Long>(lSize), tmc::CodeMap::Kind::Code);
+                if (lLeader == true)
+                {
+                    lMap.AddLeader(lFragment.mAddress);
+                }
+
+                lLeader = EndsBlock(lFragment);
+            }
+        }
+
+        lMap.Build();
+        return lMap.Save(pPath);
+    }
+
+    /* Private Methods ****************************************************************************/
+
+    tmc::ByteBuffer Writer::BuildMetadata () const
+    {
+        // The metadata fields required by the specification, up to the start of the 'METADATA'
+        // section. Every value is stored little-endian.
+        tmc::ByteBuffer lBuffer(tmc::PROGRAM_EXTRA_METADATA_START, 0);
+
+        CopyLong(lBuffer, tmc::PROGRAM_MAGIC_ADDRESS, tmc::PROGRAM_MAGIC);
+        CopyField(lBuffer, tmc::PROGRAM_NAME_ADDRESS, mName, tmc::PROGRAM_NAME_LENGTH);
+        CopyField(lBuffer, tmc::PROGRAM_AUTHOR_ADDRESS, mAuthor, tmc::PROGRAM_AUTHOR_LENGTH);
+        CopyLong(lBuffer, tmc::PROGRAM_ROM_SIZE_ADDRESS, static_cast<tmc::Long>(GetImageSize()));
+        CopyLong(lBuffer, tmc::PROGRAM_RAM_SIZE_ADDRESS, std::max<tmc::Long>(mRAMSize,
+            static_cast<tmc::Long>(mObject.GetSection(SectionType::ST_RAM).mSize)));
+
+        return lBuffer;
+    }
+
+}
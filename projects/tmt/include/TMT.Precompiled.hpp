@@ -0,0 +1,8 @@
+/// @file TMT.Precompiled.hpp
+
+#ifndef TMT_PRECOMPILED_HPP
+#define TMT_PRECOMPILED_HPP
+
+#include <TMC.Precompiled.hpp>
+
+#endif
@@ -0,0 +1,124 @@
+/// @file TMT.Main.cpp
+
+#include <TMT.Precompiled.hpp>
+#include <TMC.Processor.hpp>
+
+// A program which halts until woken, then counts once in 'A' and stops.
+static constexpr tmc::Byte HALT_PROGRAM[] = {
+    0x00, 0x02,     // halt
+    0x00, 0x30,     // inc a
+    0x00, 0x01      // stop
+};
+
+struct Machine
+{
+    tmc::ByteBuffer     mImage;
+    tmc::Bus            mBus;
+    tmc::Processor      mProcessor { mBus };
+
+    Machine ()
+    {
+        mImage.assign(tmc::PROGRAM_START, 0);
+        mImage.insert(mImage.end(), std::begin(HALT_PROGRAM), std::end(HALT_PROGRAM));
+        mBus.AttachProgram(mImage.data(), mImage.size());
+        mProcessor.Reset();
+    }
+};
+
+tmc::Boolean Check (const tmc::Char* pTest, const tmc::Boolean& pPassed, const tmc::String& pMessage)
+{
+    if (pPassed == false)
+    {
+        std::cerr << "[" << pTest << "] " << pMessage << std::endl;
+    }
+
+    return pPassed;
+}
+
+// Posts an event every 'pPeriod' cycles, for as long as 'pFire' asks it to go on.
+void ScheduleTimer (tmc::Scheduler& pScheduler, const tmc::Uint64& pTime, const tmc::Uint64& pPeriod,
+    const std::function<tmc::Boolean ()>& pFire)
+{
+    pScheduler.Schedule(pTime, [&pScheduler, pPeriod, pFire] (const tmc::Uint64& pNow)
+    {
+        if (pFire() == true)
+        {
+            ScheduleTimer(pScheduler, pNow + pPeriod, pPeriod, pFire);
+        }
+    });
+}
+
+tmc::Boolean TestIdleTimer ()
+{
+    // A halted processor, with a timer which never raises an interrupt, idles until the cycle
+    // limit, and the timer fires each time it is due on the way.
+    Machine lMachine;
+    tmc::Index lFired = 0;
+    ScheduleTimer(lMachine.mProcessor.GetScheduler(), 100, 100, [&] () { ++lFired; return true; });
+
+    const tmc::Index lCount = lMachine.mProcessor.Run(1000, 10000);
+
+    return
+        Check("TestIdleTimer", lCount == 1, "Ran " + std::to_string(lCount) + " instructions, not 1.") &&
+        Check("TestIdleTimer", lMachine.mProcessor.IsHalted() == true, "The processor woke.") &&
+        Check("TestIdleTimer", lMachine.mProcessor.GetCycles() == 10000,
+            "Stopped at cycle " + std::to_string(lMachine.mProcessor.GetCycles()) + ", not 10000.") &&
+        Check("TestIdleTimer", lFired == 99, "The timer fired " + std::to_string(lFired) + " times, not 99.");
+}
+
+tmc::Boolean TestWakingTimer ()
+{
+    // The same timer raises an interrupt on its fifth firing. That wakes the processor, which
+    // then runs on within the same call, even with interrupts disabled.
+    Machine lMachine;
+    tmc::Index lFired = 0;
+    ScheduleTimer(lMachine.mProcessor.GetScheduler(), 100, 100, [&] ()
+    {
+        if (++lFired == 5)
+        {
+            lMachine.mProcessor.RequestInterrupt(0);
+        }
+
+        return true;
+    });
+
+    const tmc::Index lCount = lMachine.mProcessor.Run(1000);
+
+    return
+        Check("TestWakingTimer", lCount == 3, "Ran " + std::to_string(lCount) + " instructions, not 3.") &&
+        Check("TestWakingTimer", lMachine.mProcessor.IsStopped() == true, "The processor did not stop.") &&
+        Check("TestWakingTimer", lMachine.mProcessor.GetRegister(0) == 1, "'A' was not counted.") &&
+        Check("TestWakingTimer", lFired == 5, "The timer fired " + std::to_string(lFired) + " times, not 5.");
+}
+
+tmc::Boolean TestNoEvents ()
+{
+    // With nothing left to wake it, a halted processor ends the run at once.
+    Machine lMachine;
+    ScheduleTimer(lMachine.mProcessor.GetScheduler(), 100, 100, [] () { return false; });
+
+    const tmc::Index lCount = lMachine.mProcessor.Run(1000);
+
+    return
+        Check("TestNoEvents", lCount == 1, "Ran " + std::to_string(lCount) + " instructions, not 1.") &&
+        Check("TestNoEvents", lMachine.mProcessor.IsHalted() == true, "The processor woke.") &&
+        Check("TestNoEvents", lMachine.mProcessor.GetScheduler().IsEmpty() == true, "An event was left.");
+}
+
+int main ()
+{
+    tmc::Index lFailed = 0;
+    for (auto lTest : { TestIdleTimer, TestWakingTimer, TestNoEvents })
+    {
+        lFailed += (lTest() == false) ? 1 : 0;
+    }
+
+    if (lFailed > 0)
+    {
+        std::cerr << "[Main] " << lFailed << " tests failed." << std::endl;
+        return 1;
+    }
+
+    std::cout << "[Main] All tests passed." << std::endl;
+    return 0;
+}
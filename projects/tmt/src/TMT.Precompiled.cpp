@@ -0,0 +1,3 @@
+/// @file TMT.Precompiled.cpp
+
+#include <TMT.Precompiled.hpp>
@@ -0,0 +1,40 @@
+; Arithmetic-heavy dispatch benchmark: long runs of arithmetic, bitwise and shift instructions
+; over every register view, with a single branch closing each pass. Runs until the benchmark's
+; instruction limit is reached.
+
+section program
+    .start:
+        ld a, 0x12345678
+        ld b, 0
+        ld c, 0x9E3779B9
+        ld d, 1
+    .loop:
+        add a, c
+        xor b, a
+        adc bw, 0x1234
+        sub c, d
+        sla a
+        or bl, ah
+        and cw, 0xF0F0
+        inc d
+        sbc a, b
+        xor ch, 0x5A
+        rl b
+        add al, bl
+        cmp a, c
+        mv cl, dh
+        swap aw
+        add d, 3
+        sub bh, cl
+        srl c
+        xor a, d
+        adc b, c
+        rrc al
+        or c, 0x01010101
+        dec bw
+        and a, b
+        add c, a
+        xor dh, 0xA5
+        sra b
+        sub aw, cw
+        jpb n, loop
@@ -0,0 +1,33 @@
+; Branch-heavy dispatch benchmark: nearly every other instruction transfers control, through
+; relative and absolute jumps, taken and untaken conditions, and calls and returns. Runs until
+; the benchmark's instruction limit is reached.
+
+section program
+    .start:
+        ld a, 0
+        ld b, 0
+    .loop:
+        inc b
+        bit 0, bl
+        jpb zs, even
+        call n, odd
+        jpb n, next
+    .even:
+        call n, even_work
+    .next:
+        cmp bl, 0x40
+        jpb cs, loop
+        bit 1, a
+        jmp zc, skip
+        xor a, b
+    .skip:
+        jmp n, loop
+
+    .odd:
+        xor a, b
+        ret zs
+        ret n
+
+    .even_work:
+        add a, b
+        ret n
@@ -0,0 +1,39 @@
+; Data merging sample: a labelled message table holding repeated strings and strings which are
+; suffixes of others, a suffix string set between code, and a table whose labels may be
+; addressed past each other, which must stay in one piece. Assemble with '-D'.
+
+section program
+    .start:
+        ld a, [tbl + 2]
+        ld b, [messages]
+        ld c, [suffix]
+        jpb n, next
+    .suffix:
+        db "world", 0
+    .next:
+        ld d, [ok]
+        stop
+
+    .messages:
+        db "hello, world", 0
+    .error:
+        db "disk error", 0
+    .again:
+        db "hello, world", 0
+    .world:
+        db "world", 0
+    .error_again:
+        db "disk error", 0
+    .ok:
+        db "ok", 0
+    .rror:
+        db "rror", 0
+
+    .tbl:
+        db 1, 2
+    .tbl2:
+        db 3, 4
+        stop
+    .pair:
+        db 3, 4
+        stop
@@ -0,0 +1,26 @@
+#!/bin/bash
+
+# Builds the emulator once per dispatch mode, and runs the benchmark ROMs in 'res/bench' on each.
+# Any further arguments are passed to the benchmark tool, e.g. '-n 500000000', '-r 5', or
+# '-x interpret' to leave every block to the interpreter.
+
+mkdir -p build/bench
+./tools/premake5 gmake >/dev/null
+make -C generated/ config=release tmm >/dev/null || exit 1
+
+for lSource in res/bench/*.asm; do
+    ./build/bin/tmm/release/tmm -a -i "$lSource" -o "build/bench/$(basename "${lSource%.asm}").tm" -r 64 || exit 1
+done
+
+for lMode in switch threaded; do
+    ./tools/premake5 --dispatch=$lMode gmake >/dev/null
+    make -C generated/ config=release clean >/dev/null
+    make -C generated/ config=release tmb >/dev/null || exit 1
+
+    for lRom in build/bench/*.tm; do
+        ./build/bin/tmb/release/tmb -i "$lRom" $@
+    done
+done
+
+# Leave the workspace generated with its default options.
+./tools/premake5 gmake >/dev/null
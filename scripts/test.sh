@@ -0,0 +1,77 @@
+#!/bin/bash
+
+# Builds the tools, and checks them against the samples in 'res/tests'. Each failed check is
+# printed, and the script fails if any did.
+
+mkdir -p build/tests
+./tools/premake5 gmake >/dev/null
+make -C generated/ config=release tmm tmt >/dev/null || exit 1
+
+lTmm=./build/bin/tmm/release/tmm
+lFailed=0
+
+Fail () {
+    echo "[Test] $1"
+    lFailed=1
+}
+
+# Prints each symbol of a map file, with its address in decimal.
+Symbols () {
+    grep -E '^  \$[0-9A-F]+  [A-Z]' "$1" | while read -r lAddress lSection lName lRest; do
+        echo "$lName $((16#${lAddress#\$}))"
+    done
+}
+
+# The emulator's own tests.
+./build/bin/tmt/release/tmt || lFailed=1
+
+# Data merging: the merged ROM must be smaller; each repeated or suffix string must share the
+# bytes of another; and each data label must still name the bytes it did, up to the next label.
+$lTmm -a -i res/tests/merge.asm -o build/tests/merge.tm -m build/tests/merge.map || exit 1
+$lTmm -a -i res/tests/merge.asm -o build/tests/merge.D.tm -m build/tests/merge.D.map -D || exit 1
+
+if [ "$(stat -c %s build/tests/merge.D.tm)" -ge "$(stat -c %s build/tests/merge.tm)" ]; then
+    Fail "merge: '-D' did not make the ROM smaller."
+fi
+
+declare -A lMerged
+while read -r lName lAddress; do
+    lMerged[$lName]=$lAddress
+done < <(Symbols build/tests/merge.D.map)
+
+for lShared in "again messages 0" "error_again error 0" "world messages 7" "suffix messages 7" \
+    "rror error 6" "pair tbl2 0"; do
+    read -r lName lHost lOffset <<< "$lShared"
+    if [ "${lMerged[$lName]}" != "$((lMerged[$lHost] + lOffset))" ]; then
+        Fail "merge: '$lName' was not merged into '$lHost'."
+    fi
+done
+
+lSymbols=($(Symbols build/tests/merge.map | sort -k2 -n))
+lEnd=$(stat -c %s build/tests/merge.tm)
+for ((lIndex = 0; lIndex < ${#lSymbols[@]}; lIndex += 2)); do
+    lName=${lSymbols[lIndex]}
+    lAddress=${lSymbols[lIndex + 1]}
+    lNext=${lSymbols[lIndex + 3]:-$lEnd}
+
+    # Code names other labels, and so changes as they move.
+    if [ "$lName" = "start" ] || [ "$lName" = "next" ]; then
+        continue
+    elif [ -z "${lMerged[$lName]}" ]; then
+        Fail "merge: '$lName' is missing from the merged map."
+    elif ! cmp -s -n $((lNext - lAddress)) -i "$lAddress:${lMerged[$lName]}" \
+        build/tests/merge.tm build/tests/merge.D.tm; then
+        Fail "merge: '$lName' names different bytes once merged."
+    fi
+done
+
+# A table addressed past its first label stays in one piece.
+if [ $((lMerged[tbl2] - lMerged[tbl])) -ne 2 ]; then
+    Fail "merge: 'tbl' and 'tbl2' were split apart."
+fi
+
+if [ $lFailed -ne 0 ]; then
+    exit 1
+fi
+
+echo "[Test] All checks passed."